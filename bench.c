@@ -0,0 +1,439 @@
+// bench.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains ossbench, a program which runs oss on a suite of named
+// scenarios, each with the same fixed seeds every time, to tell whether a
+// change made the scheduler slower. Every run records the simulated
+// throughput, dispatches per second of real time, percentiles of the real
+// time from dispatch to reply, and the cpu time and peak resident set of oss.
+//
+// The mean and standard deviation of each figure over a scenario's runs may
+// be written to a baseline file, and later runs compared against it. A figure
+// is flagged as a regression when it moved the wrong way by more than the
+// threshold and Welch's t-test finds the move significant at the 95% level.
+// Runs are made one at a time so they don't disturb one another's timing.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "confidence.h"
+#include "constants.h"
+#include "perrorExit.h"
+
+#define MAX_SCENARIO_OPTIONS 4	// Max oss arguments of a scenario
+#define MAX_EXTRA_OPTIONS 16	// Max oss arguments given with -o
+#define DISPATCH_RATE 1		// Index of dispatch_rate in benchMetrics
+
+// A named workload and the oss arguments that produce it
+typedef struct scenario {
+	const char * name;
+	const char * description;
+	char * options[MAX_SCENARIO_OPTIONS + 1];	// Ends with NULL
+	int selected;			// Nonzero if run this time
+} Scenario;
+
+// A figure recorded for every run and which way it gets worse
+typedef struct benchMetric {
+	const char * name;
+	int higherIsWorse;
+} BenchMetric;
+
+// A figure over the runs of a scenario
+typedef struct summary {
+	int n;
+	double mean;
+	double sd;
+} Summary;
+
+static void runScenario(int scenario);
+static int readMetrics(const char * path, double * values);
+static Summary summarize(int scenario, int metric);
+static void printSummaries(FILE * fp);
+static void writeBaseline(const char * path);
+static int compareBaseline(const char * path);
+static int significant(Summary current, Summary baseline);
+static double nanoseconds();
+static void usage();
+
+static Scenario scenarios[] = {
+	{"light", "a new process up to 6 seconds apart", {"-e", "6"}},
+	{"io", "nine in ten bursts block or are preempted", {"-p", "0.9"}},
+	{"realtime", "nine in ten processes are real time", {"-r", "0.9"}},
+	{"full", "a new process every second, keeping every pcb in use",
+	 {"-e", "0"}},
+	{"soak", "6000 simulated seconds of streaming after a warm-up",
+	 {"-S", "60:600:10"}}
+};
+#define NUM_SCENARIOS ((int) (sizeof(scenarios) / sizeof(Scenario)))
+
+static const BenchMetric benchMetrics[] = {
+	{"throughput", 0},
+	{"dispatch_rate", 0},		// Dispatches per second of real time
+	{"dispatch_p50_ns", 1},
+	{"dispatch_p90_ns", 1},
+	{"dispatch_p99_ns", 1},
+	{"oss_cpu_seconds", 1},
+	{"oss_max_rss_kb", 1}
+};
+#define NUM_BENCH_METRICS \
+	((int) (sizeof(benchMetrics) / sizeof(BenchMetric)))
+
+static int numRuns = DEFAULT_BENCH_RUNS;	// Runs of each scenario
+static int instance = 1;			// IPC instance of every run
+static char * extraOptions[MAX_EXTRA_OPTIONS];	// Given to every run
+static int numExtraOptions = 0;
+static double threshold = BENCH_THRESHOLD;	// Percent change flagged
+
+// Figures of each run of each scenario, and the runs that succeeded
+static double results[NUM_SCENARIOS][NUM_BENCH_METRICS][MAX_BENCH_RUNS];
+static int numResults[NUM_SCENARIOS];
+
+static char tmpDir[] = "/tmp/ossbench.XXXXXX"; // Holds metrics files
+
+int main(int argc, char * argv[]){
+	char * baselinePath = NULL;	// Baseline written, if any
+	char * comparePath = NULL;	// Baseline compared to, if any
+	char * option;
+	int opt, i, j, regressions = 0, anySelected = 0;
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "n:i:o:t:w:c:h")) != -1){
+		switch (opt){
+		case 'n':
+			numRuns = atoi(optarg);
+			break;
+		case 'i':
+			instance = atoi(optarg);
+			break;
+		case 'o':
+			for (option = strtok(optarg, " "); option != NULL
+			     && numExtraOptions < MAX_EXTRA_OPTIONS;
+			     option = strtok(NULL, " "))
+				extraOptions[numExtraOptions++] = option;
+			break;
+		case 't':
+			threshold = atof(optarg);
+			break;
+		case 'w':
+			baselinePath = optarg;
+			break;
+		case 'c':
+			comparePath = optarg;
+			break;
+		default:
+			usage();
+		}
+	}
+	if (numRuns < 1 || numRuns > MAX_BENCH_RUNS || threshold < 0)
+		usage();
+
+	// Remaining arguments pick scenarios, all of them if there are none
+	for (i = optind; i < argc; i++){
+		for (j = 0; j < NUM_SCENARIOS; j++)
+			if (strcmp(scenarios[j].name, argv[i]) == 0) break;
+		if (j == NUM_SCENARIOS) usage();
+		scenarios[j].selected = anySelected = 1;
+	}
+	for (j = 0; j < NUM_SCENARIOS; j++)
+		if (!anySelected) scenarios[j].selected = 1;
+
+	if (mkdtemp(tmpDir) == NULL)
+		perrorExit("Failed to create temporary directory");
+
+	for (i = 0; i < NUM_SCENARIOS; i++)
+		if (scenarios[i].selected) runScenario(i);
+
+	rmdir(tmpDir);
+
+	if (comparePath != NULL)
+		regressions = compareBaseline(comparePath);
+	else
+		printSummaries(stdout);
+
+	if (baselinePath != NULL)
+		writeBaseline(baselinePath);
+
+	return regressions > 0;
+}
+
+// Runs oss with every seed on one scenario, one run at a time
+static void runScenario(int scenario){
+	char * args[MAX_SCENARIO_OPTIONS + MAX_EXTRA_OPTIONS + 10];
+	char seed[BUFF_SZ], inst[BUFF_SZ], metricsPath[BUFF_SZ];
+	double values[NUM_BENCH_METRICS], start, elapsed;
+	int run, i, n, status;
+	pid_t pid;
+
+	fprintf(stderr, "%s: running %s (%s)\n", exeName,
+		scenarios[scenario].name, scenarios[scenario].description);
+
+	sprintf(inst, "%d", instance);
+	sprintf(metricsPath, "%s/metrics", tmpDir);
+
+	for (run = 0; run < numRuns; run++){
+
+		// Builds the argument vector of oss
+		sprintf(seed, "%u", BASE_SEED + run);
+		n = 0;
+		args[n++] = OSS_PATH;
+		args[n++] = "-s"; args[n++] = seed;
+		args[n++] = "-i"; args[n++] = inst;
+		args[n++] = "-L"; args[n++] = "/dev/null";
+		args[n++] = "-m"; args[n++] = metricsPath;
+		for (i = 0; scenarios[scenario].options[i] != NULL; i++)
+			args[n++] = scenarios[scenario].options[i];
+		for (i = 0; i < numExtraOptions; i++)
+			args[n++] = extraOptions[i];
+		args[n] = NULL;
+
+		start = nanoseconds();
+		if ((pid = fork()) == -1)
+			perrorExit("Failed to fork");
+
+		// Child isolates itself so oss's cleanup can't reach ossbench,
+		// and leaves out the window lines of streaming runs
+		if (pid == 0){
+			setpgid(0, 0);
+			if (freopen("/dev/null", "w", stdout) == NULL)
+				perrorExit("Failed to redirect oss's output");
+			execv(OSS_PATH, args);
+			perrorExit("Failed to exec oss");
+		}
+
+		if (waitpid(pid, &status, 0) == -1)
+			perrorExit("Failed waiting for oss");
+		elapsed = nanoseconds() - start;
+
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0
+		    || !readMetrics(metricsPath, values)){
+			fprintf(stderr, "%s: %s run with seed %s failed\n",
+				exeName, scenarios[scenario].name, seed);
+			continue;
+		}
+
+		// Turns the dispatch count into a rate of real time
+		values[DISPATCH_RATE] *= BILLION / elapsed;
+
+		for (i = 0; i < NUM_BENCH_METRICS; i++)
+			results[scenario][i][numResults[scenario]] = values[i];
+		numResults[scenario]++;
+	}
+}
+
+// Reads the figures of a run from its metrics file, then removes it,
+// returning 0 if any is missing. The dispatch count stands in for the rate.
+static int readMetrics(const char * path, double * values){
+	char name[BUFF_SZ];
+	double value;
+	int i, found = 0;
+	FILE * fp;
+
+	if ((fp = fopen(path, "r")) == NULL) return 0;
+
+	while (fscanf(fp, "%99s %lf", name, &value) == 2){
+		if (strcmp(name, "dispatches") == 0)
+			strcpy(name, benchMetrics[DISPATCH_RATE].name);
+		for (i = 0; i < NUM_BENCH_METRICS; i++){
+			if (strcmp(benchMetrics[i].name, name) == 0){
+				values[i] = value;
+				found |= 1 << i;
+			}
+		}
+	}
+
+	fclose(fp);
+	unlink(path);
+
+	return found == (1 << NUM_BENCH_METRICS) - 1;
+}
+
+// Computes the mean and standard deviation of a figure of a scenario
+static Summary summarize(int scenario, int metric){
+	Summary s = {numResults[scenario], 0, 0};
+	double squares = 0, x;
+	int i;
+
+	for (i = 0; i < s.n; i++)
+		s.mean += results[scenario][metric][i];
+	if (s.n > 0) s.mean /= s.n;
+
+	for (i = 0; i < s.n; i++){
+		x = results[scenario][metric][i] - s.mean;
+		squares += x * x;
+	}
+	if (s.n > 1) s.sd = sqrt(squares / (s.n - 1));
+
+	return s;
+}
+
+// Prints the mean and standard deviation of every figure that was run
+static void printSummaries(FILE * fp){
+	Summary s;
+	int i, j;
+
+	fprintf(fp, "%-9s %-16s %5s %16s %14s\n", "scenario", "metric", "runs",
+		"mean", "sd");
+	for (i = 0; i < NUM_SCENARIOS; i++){
+		if (!scenarios[i].selected) continue;
+		for (j = 0; j < NUM_BENCH_METRICS; j++){
+			s = summarize(i, j);
+			fprintf(fp, "%-9s %-16s %5d %16.6g %14.6g\n",
+				scenarios[i].name, benchMetrics[j].name, s.n,
+				s.mean, s.sd);
+		}
+	}
+}
+
+// Writes the summaries of the scenarios run as a baseline
+static void writeBaseline(const char * path){
+	Summary s;
+	FILE * fp;
+	int i, j;
+
+	if ((fp = fopen(path, "w")) == NULL)
+		perrorExit("Failed to open baseline file");
+
+	fprintf(fp, "# ossbench baseline: scenario metric runs mean sd\n");
+	fprintf(fp, "# oss options:");
+	for (i = 0; i < numExtraOptions; i++)
+		fprintf(fp, " %s", extraOptions[i]);
+	fprintf(fp, "\n");
+
+	for (i = 0; i < NUM_SCENARIOS; i++){
+		if (!scenarios[i].selected) continue;
+		for (j = 0; j < NUM_BENCH_METRICS; j++){
+			s = summarize(i, j);
+			fprintf(fp, "%s %s %d %.17g %.17g\n", scenarios[i].name,
+				benchMetrics[j].name, s.n, s.mean, s.sd);
+		}
+	}
+
+	fclose(fp);
+}
+
+// Prints each figure run beside its baseline, returning the regressions
+static int compareBaseline(const char * path){
+	char line[BUFF_SZ], scenario[BUFF_SZ], metric[BUFF_SZ];
+	Summary base, current;
+	int i, j, found, worse, regressions = 0;
+	const char * verdict;
+	double change;
+	FILE * fp;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		perrorExit("Failed to open baseline file");
+
+	printf("%-9s %-16s %14s %14s %8s  %s\n", "scenario", "metric",
+	       "baseline", "current", "change", "verdict");
+
+	for (i = 0; i < NUM_SCENARIOS; i++){
+		if (!scenarios[i].selected) continue;
+		for (j = 0; j < NUM_BENCH_METRICS; j++){
+			current = summarize(i, j);
+
+			// Finds the figure in the baseline
+			rewind(fp);
+			found = 0;
+			while (!found && fgets(line, BUFF_SZ, fp) != NULL)
+				found = sscanf(line, "%99s %99s %d %lf %lf",
+					       scenario, metric, &base.n,
+					       &base.mean, &base.sd) == 5
+					&& strcmp(scenario, scenarios[i].name) == 0
+					&& strcmp(metric, benchMetrics[j].name)
+					   == 0;
+			if (!found || base.n == 0 || current.n == 0){
+				printf("%-9s %-16s %14s %14.6g %8s  %s\n",
+				       scenarios[i].name, benchMetrics[j].name,
+				       "-", current.mean, "-", "no baseline");
+				continue;
+			}
+
+			change = base.mean != 0
+				 ? 100 * (current.mean - base.mean) / base.mean
+				 : 0;
+			worse = benchMetrics[j].higherIsWorse
+				? current.mean > base.mean
+				: current.mean < base.mean;
+
+			// Flags moves past the threshold that aren't noise
+			if (fabs(change) < threshold
+			    || !significant(current, base)){
+				verdict = "same";
+			} else if (worse){
+				verdict = "REGRESSION";
+				regressions++;
+			} else {
+				verdict = "improved";
+			}
+
+			printf("%-9s %-16s %14.6g %14.6g %+7.1f%%  %s\n",
+			       scenarios[i].name, benchMetrics[j].name,
+			       base.mean, current.mean, change, verdict);
+		}
+	}
+
+	fclose(fp);
+
+	printf("%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+	return regressions;
+}
+
+// Returns nonzero if Welch's t-test finds the means differ at the 95% level
+static int significant(Summary current, Summary baseline){
+	double vc = current.n > 1 ? current.sd * current.sd / current.n : 0;
+	double vb = baseline.n > 1 ? baseline.sd * baseline.sd / baseline.n : 0;
+	double t, df;
+
+	// Figures without spread differ whenever their means do
+	if (vc + vb == 0)
+		return current.mean != baseline.mean;
+
+	// Welch-Satterthwaite degrees of freedom
+	t = (current.mean - baseline.mean) / sqrt(vc + vb);
+	df = (vc + vb) * (vc + vb)
+	     / ((current.n > 1 ? vc * vc / (current.n - 1) : 0)
+		+ (baseline.n > 1 ? vb * vb / (baseline.n - 1) : 0));
+
+	return fabs(t) > tCritical((int) df);
+}
+
+// Returns a monotonic time in nanoseconds
+static double nanoseconds(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * (double) BILLION + now.tv_nsec;
+}
+
+// Prints the accepted options and scenarios to stderr and exits
+static void usage(){
+	int i;
+
+	fprintf(stderr,
+		"Usage: %s [options] [scenario]...\n"
+		"  -n n      runs each scenario with seeds %d through %d + n"
+		" - 1 (default\n"
+		"            n = %d)\n"
+		"  -i n      IPC instance of the runs (default 1)\n"
+		"  -o opts   passes opts, quoted, to every run of oss\n"
+		"  -t pct    smallest change flagged, in percent"
+		" (default %d)\n"
+		"  -w path   writes the results as a baseline\n"
+		"  -c path   compares the results with a baseline, exiting"
+		" with 1 on a\n"
+		"            regression\n"
+		"Scenarios, all run if none are named:\n",
+		exeName, BASE_SEED, BASE_SEED, DEFAULT_BENCH_RUNS,
+		BENCH_THRESHOLD);
+	for (i = 0; i < NUM_SCENARIOS; i++)
+		fprintf(stderr, "  %-9s %s\n", scenarios[i].name,
+			scenarios[i].description);
+	exit(1);
+}
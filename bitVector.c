@@ -12,6 +12,7 @@
 #include <stdio.h>
 #endif
 static unsigned int bitVector[BIT_VECTOR_SIZE];
+static int candidate = 0; 	// Used to generate ints
 
 void initializeBitVector(){
         int i;
@@ -67,7 +68,6 @@ void freeInBitVector(int num){
 
 // Returns the next unused integer in the bit vector
 int getIntFromBitVector(){
-	static int candidate = 0; 	// Used to generate ints
 	int numChecked = 0;		// The number of integers checked
 
 #ifdef DEBUG_BV
@@ -101,3 +101,29 @@ int getIntFromBitVector(){
 	return candidate;		
 }
 
+// Returns what getIntFromBitVector would return if num (when not -1) were free
+int peekIntFromBitVector(int num){
+	int next = candidate;
+	int numChecked = 0;
+
+	while (isReservedInBitVector(next) && next != num){
+		if (++next > MAX_VALUE) next = 0;
+		if (++numChecked > MAX_VALUE) return -1;
+	}
+
+	return next;
+}
+
+// Copies the bit vector and the next candidate int, for checkpoints
+void saveBitVector(unsigned int vector[], int * next){
+	int i;
+	for (i = 0; i < BIT_VECTOR_SIZE; i++) vector[i] = bitVector[i];
+	*next = candidate;
+}
+
+// Restores a bit vector and next candidate saved with saveBitVector
+void restoreBitVector(const unsigned int vector[], int next){
+	int i;
+	for (i = 0; i < BIT_VECTOR_SIZE; i++) bitVector[i] = vector[i];
+	candidate = next;
+}
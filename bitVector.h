@@ -12,3 +12,8 @@ void freeInBitVector(int num);
 
 int getIntFromBitVector();
 
+int peekIntFromBitVector(int num);
+
+void saveBitVector(unsigned int vector[], int * next);
+
+void restoreBitVector(const unsigned int vector[], int next);
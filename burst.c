@@ -0,0 +1,164 @@
+// burst.c was created by Mark Renard on 10/19/2026 from functions written for
+// userProgram.c on 3/26/2020.
+//
+// This file contains the logic that decides how a simulated process uses a
+// time quantum. It is run by userProgram after each dispatch message, and by
+// oss itself for every process when it simulates processes in-process. It
+// draws from the current random generator, so each process should have its
+// own.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "burst.h"
+#include "constants.h"
+#include "parameters.h"
+#include "randomGen.h"
+
+static void terminateProcedure(char * msgText);
+static void blockProcedure(char * msgText, int r, int s, int device);
+static void preemptProcedure(char * msgText);
+static void useEntireQuantumProcedure(char * msgText);
+
+// Replaces a dispatch message with the reply, returning nonzero on termination
+int simulateBurst(char * msgBuff){
+	int finished = 0; // Nonzero when finished
+
+	// Decides if process terminates before using entire quantum
+	if (randBinary(TERMINATION_PROBABILITY)){
+		finished = 1;
+		terminateProcedure(msgBuff);
+
+	// Determines whether process will get blocked or preempted
+	} else if (randBinary(params.interruptProbability)){
+		unsigned int r = randUnsigned(0, 3);
+		unsigned int s = randUnsigned(0, 1000);
+		int device = -1;
+
+		if (r == 3){
+			preemptProcedure(msgBuff);
+		} else {
+			// Names a device only with -D, keeping others' draws
+			if (params.numDevices > 0)
+				device = randUnsigned(0,
+						      params.numDevices - 1);
+			blockProcedure(msgBuff, r, s, device);
+		}
+
+	// Indicates that the process will not terminate within quantum
+	} else {
+		// Creates message indicating non-termination
+		useEntireQuantumProcedure(msgBuff);
+	}
+
+	return finished;
+}
+
+// Changes msgText indicating partial quantum use before termination
+static void terminateProcedure(char * msgText){
+	unsigned int usedNano;	// Stores burst length in nanoseconds
+	unsigned int quantum = atoi(msgText);
+
+	// Generates random number in range [0, quantum] to see how long it runs
+	usedNano = randUnsigned(0, quantum);
+
+	createReplyMessage(msgText, TERMINATION_CH, usedNano, -1, -1, -1);
+}
+
+// Changes msgText indicating use of entire quantum
+static void useEntireQuantumProcedure(char * msgText){
+	unsigned int quantum = atoi(msgText);
+
+	createReplyMessage(msgText, USES_ALL_QUANTUM_CH, quantum, -1, -1, -1);
+}
+
+// Changes msgText indicating the process has been prempted
+static void preemptProcedure(char * msgText){
+	unsigned int quantum = atoi(msgText);
+	unsigned int usedNano;
+
+	usedNano = quantum * randUnsigned(1, 99) / 100;
+
+	createReplyMessage(msgText, PREEMPT_CH, usedNano, -1, -1, -1);
+}
+
+// Changes msgText indicating the process is blocking, waiting for I/O from
+// device, or for a timed event if device is -1
+static void blockProcedure(char * msgText, int r, int s, int device){
+	unsigned int usedNano;
+	unsigned int quantum = atoi(msgText);
+
+	usedNano = randUnsigned(0, quantum);
+
+	createReplyMessage(msgText, WAITING_FOR_IO_CH, usedNano, r, s, device);
+}
+
+// Changes msgText to use in the repy queue, naming device if it is not -1
+void createReplyMessage(char * msgText, char stateChar, int usedNano, 
+			int r, int s, int device){
+	int i = 0;
+	
+	// Adds stateChar
+	msgText[i++] = stateChar;
+	msgText[i++] = DELIM;
+
+	// Adds time used
+	char usedNanoBuff[BUFF_SZ];
+	sprintf(usedNanoBuff, "%d", usedNano);
+
+	do {
+		msgText[i] = usedNanoBuff[i - 2];
+	} while (msgText[i++] != '\0');
+	msgText[i++] = DELIM;
+
+	// Adds time of I/O event if blocking
+	if (stateChar == WAITING_FOR_IO_CH){
+		char rBuff[BUFF_SZ];
+		char sBuff[BUFF_SZ];
+
+		// Converts ints to strings
+		sprintf(rBuff, "%d", r);
+		sprintf(sBuff, "%d", s);
+
+		// Copies r
+		int j = 0;
+		do {
+			msgText[i] = rBuff[j++];
+		} while (msgText[i++] != '\0');
+		msgText[i++] = DELIM;
+
+		// Copies s
+		j = 0;
+		do {
+			msgText[i] = sBuff[j++];
+		} while (msgText[i++] != '\0');
+		msgText[i++] = DELIM;
+
+		// Copies the device the process waits for, if any
+		if (device != -1){
+			i += sprintf(msgText + i, "%d", device) + 1;
+			msgText[i++] = DELIM;
+		}
+	}
+}
+
+// Replaces the time used in a reply with usedNano, keeping the rest
+void setBurstTime(char * msgText, unsigned int usedNano){
+	const char * field = msgText + 2;
+	int r = -1, s = -1, device = -1;
+
+	// Reads r, s and any device, which follow the time, if blocking
+	if (msgText[0] == WAITING_FOR_IO_CH){
+		field += strlen(field) + 2;
+		r = atoi(field);
+		field += strlen(field) + 2;
+		s = atoi(field);
+		if (params.numDevices > 0){
+			field += strlen(field) + 2;
+			device = atoi(field);
+		}
+	}
+
+	createReplyMessage(msgText, msgText[0], usedNano, r, s, device);
+}
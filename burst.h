@@ -0,0 +1,14 @@
+// burst.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers of the function that simulates a process's use
+// of the quantum in a dispatch message and of functions that build its reply.
+
+#ifndef BURST_H
+#define BURST_H
+
+int simulateBurst(char * msgBuff);
+void createReplyMessage(char * msgText, char stateChar, int usedNano, int r,
+			int s, int device);
+void setBurstTime(char * msgText, unsigned int usedNano);
+
+#endif
@@ -28,7 +28,7 @@ int main(int argc, char * argv[]){
 	if (argc < 2 || (seed = (unsigned int)atoi(argv[1])) == 0)
 		perrorExit("The first argument must be a non-zero seed");
 
-	srand(seed);
+	seedRandom(seed);
 
 	initializeBitVector();
 
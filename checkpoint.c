@@ -0,0 +1,130 @@
+// checkpoint.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that write checkpoints of an
+// in-process run of oss to a memory-mapped file and read them back.
+//
+// The file holds a header page followed by two page-aligned slots. Each
+// checkpoint goes to the slot not holding the latest one, and the header is
+// only pointed at it once it is complete, so a run killed mid-write leaves the
+// previous checkpoint intact. Only pages that differ from what the slot
+// already holds are copied, and the kernel writes dirty pages back on its own
+// schedule, so a checkpoint costs oss little more than a pass of memcmp.
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+#include "perrorExit.h"
+
+#define CHECKPOINT_MAGIC 0x4f53534bU	// Identifies checkpoint files
+#define NUM_SLOTS 2			// Checkpoints kept in the file
+
+typedef struct checkpointHeader {
+	unsigned int magic;		// CHECKPOINT_MAGIC
+	unsigned int checkpointSize;	// Rejects files from other builds
+	int latest;			// Slot of the newest checkpoint, or -1
+} CheckpointHeader;
+
+static char * map = NULL;	// The mapped checkpoint file
+static size_t pageSize;		// Size of the header and unit of copying
+static size_t slotSize;		// Size of a checkpoint rounded up to pages
+
+// Sets pageSize and slotSize and returns the size of a checkpoint file
+static size_t fileSize(){
+	pageSize = sysconf(_SC_PAGESIZE);
+	slotSize = (sizeof(Checkpoint) + pageSize - 1) / pageSize * pageSize;
+
+	return pageSize + NUM_SLOTS * slotSize;
+}
+
+// Returns a pointer to a slot in the mapped file
+static char * slotAt(int slot){
+	return map + pageSize + slot * slotSize;
+}
+
+// Creates or truncates the checkpoint file at path and maps it
+void openCheckpointFile(const char * path){
+	CheckpointHeader * header;
+	size_t size = fileSize();
+	int fd;
+
+	if ((fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)) == -1
+	    || ftruncate(fd, size) == -1)
+		perrorExit("checkpoint.c - failed to create checkpoint file");
+
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		perrorExit("checkpoint.c - failed to map checkpoint file");
+	close(fd);
+
+	header = (CheckpointHeader *) map;
+	header->magic = CHECKPOINT_MAGIC;
+	header->checkpointSize = sizeof(Checkpoint);
+	header->latest = -1;
+}
+
+// Copies a checkpoint into the older slot and marks it as the latest
+void writeCheckpoint(const Checkpoint * cp){
+	CheckpointHeader * header = (CheckpointHeader *) map;
+	int slot = header->latest == 0 ? 1 : 0;
+	const char * source = (const char *) cp;
+	char * dest = slotAt(slot);
+	size_t offset, length;
+
+	// Copies the pages that changed since the slot was last written
+	for (offset = 0; offset < sizeof(Checkpoint); offset += pageSize){
+		length = sizeof(Checkpoint) - offset;
+		if (length > pageSize) length = pageSize;
+
+		if (memcmp(dest + offset, source + offset, length) != 0)
+			memcpy(dest + offset, source + offset, length);
+	}
+
+	// Publishes the slot after its contents, then starts writeback
+	__atomic_store_n(&header->latest, slot, __ATOMIC_RELEASE);
+	msync(map, pageSize + NUM_SLOTS * slotSize, MS_ASYNC);
+}
+
+// Flushes and unmaps the checkpoint file
+void closeCheckpointFile(){
+	size_t size = pageSize + NUM_SLOTS * slotSize;
+
+	if (map == NULL) return;
+
+	msync(map, size, MS_SYNC);
+	munmap(map, size);
+	map = NULL;
+}
+
+// Copies the latest checkpoint in the file at path, exiting if there is none
+void readCheckpoint(const char * path, Checkpoint * cp){
+	const CheckpointHeader * header;
+	size_t size = fileSize();
+	struct stat st;
+	char * file;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) == -1 || fstat(fd, &st) == -1)
+		perrorExit("checkpoint.c - failed to open checkpoint file");
+
+	if ((size_t) st.st_size != size)
+		perrorExit("checkpoint.c - checkpoint file has the wrong size");
+
+	file = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (file == MAP_FAILED)
+		perrorExit("checkpoint.c - failed to map checkpoint file");
+	close(fd);
+
+	header = (const CheckpointHeader *) file;
+	if (header->magic != CHECKPOINT_MAGIC
+	    || header->checkpointSize != sizeof(Checkpoint)
+	    || header->latest < 0 || header->latest >= NUM_SLOTS)
+		perrorExit("checkpoint.c - no usable checkpoint in file");
+
+	memcpy(cp, file + pageSize + header->latest * slotSize,
+	       sizeof(Checkpoint));
+	munmap(file, size);
+}
@@ -0,0 +1,51 @@
+// checkpoint.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the Checkpoint type, which holds
+// everything oss needs to continue a run simulated in-process, and headers
+// for functions that write checkpoints to a memory-mapped file and read them
+// back.
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "clock.h"
+#include "constants.h"
+#include "logging.h"
+#include "multiQueue.h"
+#include "parameters.h"
+#include "pcb.h"
+#include "quantum.h"
+#include "randomGen.h"
+#include "statistics.h"
+
+typedef struct checkpoint {
+	unsigned long sequence;		// Counts checkpoints written in the run
+	Parameters params;		// Settings of the run, with every
+					// pointer cleared
+
+	// State of the main loop of oss
+	Clock systemClock;		// Simulated time
+	long totalGenerated;		// Processes generated so far
+	Clock timeToGenerate;		// Time to generate the next process
+	RandomGenerator generator;	// Generator used by oss itself
+
+	// Process table and queues
+	ProcessControlBlock blocks[MAX_BLOCKS];
+	ProcessAccounting accounting[MAX_BLOCKS];
+	MultiQueue multiQueue;
+	Quanta quanta;			// Adaptive quanta and their estimates
+	unsigned int bitVector[BIT_VECTOR_SIZE];
+	int nextSimPid;			// Next simPid tried by the bit vector
+
+	// Output written so far
+	LogPosition logPosition;	// End of the log
+	Statistics statistics;
+
+} Checkpoint;
+
+void openCheckpointFile(const char * path);
+void writeCheckpoint(const Checkpoint * cp);
+void closeCheckpointFile();
+void readCheckpoint(const char * path, Checkpoint * cp);
+
+#endif
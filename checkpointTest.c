@@ -0,0 +1,129 @@
+// checkpointTest.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a test of checkpoints taken by oss with -c and resumed
+// with -R. A run checkpointed with a trace and a burst history must leave no
+// pointer in the Parameters of its checkpoint, since the pointers would be
+// into the argv of a process that is gone, and resuming it must succeed. -D
+// with -c, and -t or -b with -R, must be refused. Run it from the directory
+// holding oss.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+#include "constants.h"
+#include "perrorExit.h"
+
+static char dir[] = "/tmp/checkpointTest.XXXXXX";
+static char checkpointPath[BUFF_SZ], logPath[BUFF_SZ], metricsPath[BUFF_SZ];
+static char tracePath[BUFF_SZ], historyPath[BUFF_SZ];
+static Checkpoint checkpoint;
+
+// Runs oss with args, hiding its output, and returns nonzero if it succeeded
+static int runOss(char * args[]){
+	int status, null;
+	pid_t pid;
+
+	if ((pid = fork()) == -1)
+		perrorExit("Failed to fork");
+
+	if (pid == 0){
+		if ((null = open("/dev/null", O_WRONLY)) != -1){
+			dup2(null, STDOUT_FILENO);
+			dup2(null, STDERR_FILENO);
+		}
+		execv(OSS_PATH, args);
+		perrorExit("Failed to exec oss");
+	}
+
+	if (waitpid(pid, &status, 0) == -1)
+		perrorExit("Failed waiting for oss");
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Returns the number of pointers left set in saved settings
+static int pointersSet(const Parameters * p){
+	int i, set = 0;
+
+	set += p->logPath != NULL;
+	set += p->metricsPath != NULL;
+	set += p->sketchPath != NULL;
+	set += p->tracePath != NULL;
+	set += p->historyPath != NULL;
+	set += p->checkpointPath != NULL;
+	set += p->restorePath != NULL;
+	for (i = 0; i < MAX_LOCKSTEP_CONFIGS; i++)
+		set += p->lockstepConfigs[i] != NULL;
+	set += p->placementCpus != NULL;
+
+	return set;
+}
+
+int main(int argc, char * argv[]){
+	char * take[] = {OSS_PATH, "-I", "-c", checkpointPath, "-t", tracePath,
+			 "-b", historyPath, "-L", logPath, "-m", metricsPath,
+			 NULL};
+	char * resume[] = {OSS_PATH, "-R", checkpointPath, "-L", logPath,
+			   "-m", metricsPath, NULL};
+	char * resumeTrace[] = {OSS_PATH, "-R", checkpointPath, "-t",
+				tracePath, "-L", logPath, NULL};
+	char * resumeHistory[] = {OSS_PATH, "-R", checkpointPath, "-b",
+				  historyPath, "-L", logPath, NULL};
+	char * takeDevices[] = {OSS_PATH, "-I", "-c", checkpointPath, "-D",
+				"disk:fifo:1-5", "-L", logPath, NULL};
+	int failures = 0;
+
+	exeName = argv[0];
+
+	if (mkdtemp(dir) == NULL)
+		perrorExit("Failed to create temporary directory");
+	sprintf(checkpointPath, "%s/checkpoint", dir);
+	sprintf(logPath, "%s/log", dir);
+	sprintf(metricsPath, "%s/metrics", dir);
+	sprintf(tracePath, "%s/trace.json", dir);
+	sprintf(historyPath, "%s/history", dir);
+
+	// A run with a trace and history leaves no pointer in its checkpoint
+	if (!runOss(take)){
+		printf("checkpointed run failed\n");
+		failures++;
+	} else {
+		readCheckpoint(checkpointPath, &checkpoint);
+		if (pointersSet(&checkpoint.params) > 0){
+			printf("checkpoint holds %d pointers\n",
+			       pointersSet(&checkpoint.params));
+			failures++;
+		}
+
+		// Resuming it succeeds, without a trace or history of its own
+		if (!runOss(resume)){
+			printf("resumed run failed\n");
+			failures++;
+		}
+		if (runOss(resumeTrace) || runOss(resumeHistory)){
+			printf("-t or -b accepted with -R\n");
+			failures++;
+		}
+	}
+
+	// Devices can't be checkpointed
+	if (runOss(takeDevices)){
+		printf("-D accepted with -c\n");
+		failures++;
+	}
+
+	unlink(checkpointPath);
+	unlink(logPath);
+	unlink(metricsPath);
+	unlink(tracePath);
+	unlink(historyPath);
+	rmdir(dir);
+
+	printf("%d failures\n", failures);
+
+	return failures > 0;
+}
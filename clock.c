@@ -93,13 +93,14 @@ Clock clockSum(Clock t1, Clock t2){
 Clock clockDiff(Clock t1, Clock t2){
 	t1.seconds -= t2.seconds;
 
-	t1.nanoseconds -= t2.nanoseconds;
-
-	if (t1.nanoseconds < 0){
+	// Borrows a second if t2 has more nanoseconds (fields are unsigned)
+	if (t1.nanoseconds < t2.nanoseconds){
 		t1.nanoseconds += BILLION;
 		t1.seconds -= 1;
 	}
 
+	t1.nanoseconds -= t2.nanoseconds;
+
 	return t1;
 }
 
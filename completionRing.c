@@ -0,0 +1,138 @@
+// completionRing.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that publish replies to and
+// drain them from a CompletionRing.
+//
+// Each slot carries a sequence number. A producer claims a ticket by
+// incrementing the tail, waits until the slot's sequence equals the ticket,
+// which only happens when the ring is full, fills the slot and publishes it by
+// setting the sequence to ticket + 1. The consumer takes slots in ticket order
+// while their sequence says they are published, and frees each by setting the
+// sequence to the ticket one lap later.
+//
+// When the ring is empty the consumer sets sleeping, checks the ring once more
+// and sleeps on the doorbell futex. Producers ring the doorbell only if the
+// consumer is asleep, so publishing costs no system call while oss is busy.
+//
+// A producer that dies between claiming a ticket and publishing it leaves a
+// slot that is never published, and the consumer can take nothing after it.
+// The ring can't tell a dead producer from a slow one, so it doesn't detect
+// this. oss does: it waits for replies with a timeout, handling child exits
+// in between, and a user process that exits before its termination was
+// processed ends the run, so a stalled ring stops oss rather than hanging it.
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "completionRing.h"
+#include "perrorExit.h"
+#include "seqlock.h"
+
+#define MASK (COMPLETION_RING_SIZE - 1)
+#define SPIN_LIMIT 100		// Spins before a producer yields the cpu
+
+_Static_assert((COMPLETION_RING_SIZE & MASK) == 0,
+	       "COMPLETION_RING_SIZE must be a power of two");
+
+// Sets every slot free for the first lap and the ring empty
+void initializeCompletionRing(CompletionRing * ring){
+	unsigned int i;
+
+	for (i = 0; i < COMPLETION_RING_SIZE; i++)
+		__atomic_store_n(&ring->slots[i].sequence, i, __ATOMIC_RELAXED);
+
+	ring->head = 0;
+	ring->doorbell = 0;
+	__atomic_store_n(&ring->sleeping, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&ring->tail, 0, __ATOMIC_RELEASE);
+}
+
+// Adds a completion to the ring, waking the consumer if it is asleep
+void publishCompletion(CompletionRing * ring, const Completion * completion){
+	unsigned int ticket;
+	CompletionSlot * slot;
+	int spins = 0;
+
+	ticket = __atomic_fetch_add(&ring->tail, 1, __ATOMIC_RELAXED);
+	slot = &ring->slots[ticket & MASK];
+
+	// Waits for the consumer to free the slot if the ring is full
+	while (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != ticket){
+		if (++spins < SPIN_LIMIT){
+			CPU_RELAX();
+		} else {
+			sched_yield();
+			spins = 0;
+		}
+	}
+
+	slot->completion = *completion;
+	__atomic_store_n(&slot->sequence, ticket + 1, __ATOMIC_RELEASE);
+
+	// Orders the publication before the check, as the consumer does
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->sleeping, __ATOMIC_RELAXED)){
+		__atomic_fetch_add(&ring->doorbell, 1, __ATOMIC_RELEASE);
+		syscall(SYS_futex, &ring->doorbell, FUTEX_WAKE, 1, NULL,
+			NULL, 0);
+	}
+}
+
+// Copies up to max published completions into batch and returns the count
+int drainCompletions(CompletionRing * ring, Completion * batch, int max){
+	CompletionSlot * slot;
+	int count = 0;
+
+	while (count < max){
+		slot = &ring->slots[ring->head & MASK];
+
+		if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE)
+		    != ring->head + 1)
+			break;
+
+		batch[count++] = slot->completion;
+		__atomic_store_n(&slot->sequence,
+				 ring->head + COMPLETION_RING_SIZE,
+				 __ATOMIC_RELEASE);
+		ring->head++;
+	}
+
+	return count;
+}
+
+// Drains completions, sleeping up to timeoutMs (-1 for ever) if there are none
+int waitForCompletions(CompletionRing * ring, Completion * batch, int max,
+		       int timeoutMs){
+	struct timespec timeout = {timeoutMs / 1000,
+				   (timeoutMs % 1000) * MILLION};
+	unsigned int doorbell;
+	int count;
+
+	if ((count = drainCompletions(ring, batch, max)) > 0)
+		return count;
+
+	// Announces the sleep, then checks again before committing to it
+	doorbell = __atomic_load_n(&ring->doorbell, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&ring->sleeping, 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if ((count = drainCompletions(ring, batch, max)) == 0){
+
+		// Returns at once if a producer rang since doorbell was read
+		if (syscall(SYS_futex, &ring->doorbell, FUTEX_WAIT, doorbell,
+			    timeoutMs < 0 ? NULL : &timeout, NULL, 0) == -1
+		    && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+			perrorExit("completionRing.c - futex wait failed");
+
+		count = drainCompletions(ring, batch, max);
+	}
+
+	__atomic_store_n(&ring->sleeping, 0, __ATOMIC_RELAXED);
+
+	return count;
+}
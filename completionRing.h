@@ -0,0 +1,47 @@
+// completionRing.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the CompletionRing type, a bounded
+// multi-producer, single-consumer queue of replies in shared memory, and
+// headers for functions that use it. User processes publish replies to it
+// and oss drains them in batches, sleeping on a futex when it is empty.
+
+#ifndef COMPLETIONRING_H
+#define COMPLETIONRING_H
+
+#include "constants.h"
+
+typedef struct completion {
+	int simPid;			// The process that sent the reply
+	unsigned int generation;	// Lifetime of simPid that sent it
+	char msgText[MSG_SZ];		// The reply, as sent on the queue
+} Completion;
+
+typedef struct completionSlot {
+	unsigned int sequence;		// Ticket the slot is ready for next
+	Completion completion;
+} CompletionSlot;
+
+typedef struct completionRing {
+
+	// Claimed by producers with one fetch-and-add each
+	unsigned int tail __attribute__((aligned(CACHE_LINE_SIZE)));
+
+	// Only touched by the consumer
+	unsigned int head __attribute__((aligned(CACHE_LINE_SIZE)));
+
+	// Futex the consumer sleeps on, and whether it is asleep
+	unsigned int doorbell __attribute__((aligned(CACHE_LINE_SIZE)));
+	unsigned int sleeping;
+
+	CompletionSlot slots[COMPLETION_RING_SIZE]
+		__attribute__((aligned(CACHE_LINE_SIZE)));
+
+} CompletionRing;
+
+void initializeCompletionRing(CompletionRing * ring);
+void publishCompletion(CompletionRing * ring, const Completion * completion);
+int drainCompletions(CompletionRing * ring, Completion * batch, int max);
+int waitForCompletions(CompletionRing * ring, Completion * batch, int max,
+		       int timeoutMs);
+
+#endif
@@ -0,0 +1,160 @@
+// compress.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that compress and decompress
+// blocks with a byte-oriented LZ77 coder in the style of LZ4. A block is a
+// run of sequences, each a token byte, literal bytes copied as they are, and
+// a match copied from earlier output. The high half of the token is the
+// number of literals and the low half the match length less MIN_MATCH, with
+// 15 meaning more length follows in bytes of 255 and a last smaller byte. A
+// match is given by a two byte offset back from the end of the output. The
+// last sequence of a block has literals only.
+//
+// Matches are found through a table of the last position each hash of four
+// bytes was seen at, so compressing costs one table lookup per byte and
+// decompressing is mostly copying, cheap enough to keep up with the log.
+
+#include <string.h>
+
+#include "compress.h"
+
+#define HASH_BITS 12
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+
+// Reads four bytes at p without alignment requirements
+static unsigned int read32(const char * p){
+	unsigned int value;
+
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+// Hashes the four bytes at p into the match table
+static unsigned int hash(const char * p){
+	return (read32(p) * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Writes the part of a length that didn't fit in a token, returning the end
+static char * writeLength(char * out, int length){
+	for (; length >= 255; length -= 255) *out++ = (char) 255;
+	*out++ = length;
+
+	return out;
+}
+
+// Writes a sequence of literals and a match, or literals only if matchLength
+// is 0, returning the end of the output
+static char * writeSequence(char * out, const char * literals,
+			    int numLiterals, int offset, int matchLength){
+	char * token = out++;
+	int matchCode = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+
+	*token = (numLiterals < 15 ? numLiterals : 15) << 4
+		 | (matchCode < 15 ? matchCode : 15);
+	if (numLiterals >= 15) out = writeLength(out, numLiterals - 15);
+
+	memcpy(out, literals, numLiterals);
+	out += numLiterals;
+
+	if (matchLength == 0) return out;
+
+	*out++ = offset & 0xff;
+	*out++ = offset >> 8;
+	if (matchCode >= 15) out = writeLength(out, matchCode - 15);
+
+	return out;
+}
+
+// Compresses length bytes of in, returning the size written to out, which
+// must hold COMPRESS_BOUND(length) bytes
+int compressBlock(const char * in, int length, char * out){
+	int table[1 << HASH_BITS];
+	int i = 0, anchor = 0, candidate, matchLength;
+	unsigned int h;
+	char * end = out;
+
+	memset(table, -1, sizeof(table));
+
+	while (i + MIN_MATCH <= length){
+		h = hash(in + i);
+		candidate = table[h];
+		table[h] = i;
+
+		if (candidate < 0 || i - candidate > MAX_OFFSET
+		    || read32(in + candidate) != read32(in + i)){
+			i++;
+			continue;
+		}
+
+		// Extends the match as far as the input allows
+		matchLength = MIN_MATCH;
+		while (i + matchLength < length
+		       && in[candidate + matchLength] == in[i + matchLength])
+			matchLength++;
+
+		end = writeSequence(end, in + anchor, i - anchor,
+				    i - candidate, matchLength);
+		i += matchLength;
+		anchor = i;
+	}
+
+	end = writeSequence(end, in + anchor, length - anchor, 0, 0);
+
+	return end - out;
+}
+
+// Reads the rest of a length from in, returning -1 past end
+static int readLength(const char ** in, const char * end, int length){
+	unsigned char byte;
+
+	do {
+		if (*in >= end) return -1;
+		byte = *(*in)++;
+		length += byte;
+	} while (byte == 255);
+
+	return length;
+}
+
+// Decompresses length bytes of in into out, returning the size of the output
+// or -1 if the block is corrupt or doesn't fit in capacity bytes
+int decompressBlock(const char * in, int length, char * out, int capacity){
+	const char * end = in + length;
+	int size = 0, numLiterals, matchLength, offset;
+	unsigned char token;
+
+	while (in < end){
+		token = *in++;
+
+		// Copies the literals
+		numLiterals = token >> 4;
+		if (numLiterals == 15
+		    && (numLiterals = readLength(&in, end, 15)) == -1)
+			return -1;
+		if (numLiterals > end - in || numLiterals > capacity - size)
+			return -1;
+		memcpy(out + size, in, numLiterals);
+		in += numLiterals;
+		size += numLiterals;
+
+		// The last sequence has no match
+		if (in == end) break;
+
+		// Copies the match a byte at a time, since it may overlap
+		if (end - in < 2) return -1;
+		offset = (unsigned char) in[0] | (unsigned char) in[1] << 8;
+		in += 2;
+		matchLength = token & 15;
+		if (matchLength == 15
+		    && (matchLength = readLength(&in, end, 15)) == -1)
+			return -1;
+		matchLength += MIN_MATCH;
+		if (offset == 0 || offset > size
+		    || matchLength > capacity - size)
+			return -1;
+		for (; matchLength > 0; matchLength--, size++)
+			out[size] = out[size - offset];
+	}
+
+	return size;
+}
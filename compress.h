@@ -0,0 +1,15 @@
+// compress.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions that compress and decompress
+// blocks of bytes with a small LZ77 coder, used for compressed log segments.
+
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+// Largest compressed size of a block of n bytes
+#define COMPRESS_BOUND(n) ((n) + (n) / 255 + 16)
+
+int compressBlock(const char * in, int length, char * out);
+int decompressBlock(const char * in, int length, char * out, int capacity);
+
+#endif
@@ -0,0 +1,78 @@
+// compressTest.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a test of the block coder in compress.c. Blocks of log
+// lines, random bytes, runs of one byte and every length up to a few hundred
+// are compressed and decompressed, and each must come back unchanged. The
+// compressed size of the log lines is printed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compress.h"
+#include "constants.h"
+
+#define BLOCK_SIZE LOG_BUFFER_SIZE
+
+static char in[BLOCK_SIZE];
+static char packed[COMPRESS_BOUND(BLOCK_SIZE)];
+static char out[BLOCK_SIZE];
+
+// Compresses and decompresses length bytes of in, returning the packed size
+// or -1 if they didn't come back unchanged
+static int roundTrip(int length){
+	int size = compressBlock(in, length, packed);
+
+	if (size > COMPRESS_BOUND(length)
+	    || decompressBlock(packed, size, out, sizeof(out)) != length
+	    || memcmp(in, out, length) != 0)
+		return -1;
+
+	return size;
+}
+
+// Reports a failed round trip and returns 1, or returns 0
+static int check(const char * name, int length){
+	if (roundTrip(length) >= 0) return 0;
+
+	printf("%s: round trip of %d bytes failed\n", name, length);
+	return 1;
+}
+
+int main(){
+	int i, length, failures = 0, size;
+
+	// Lines like those oss logs
+	for (length = 0; length + BUFF_SZ < BLOCK_SIZE; )
+		length += sprintf(in + length, "OSS: Dispatching process with"
+				  " PID %d from queue %d at time %03d : %09d\n",
+				  rand() % 18, rand() % 4, rand() % 1000,
+				  rand() % 1000000000);
+	failures += check("log lines", length);
+	size = roundTrip(length);
+	printf("log lines: %d bytes packed into %d (%.1f%%)\n", length, size,
+	       100.0 * size / length);
+
+	// Bytes that don't compress
+	for (i = 0; i < BLOCK_SIZE; i++) in[i] = rand();
+	failures += check("random bytes", BLOCK_SIZE);
+
+	// One long match that overlaps its source
+	memset(in, 'x', BLOCK_SIZE);
+	failures += check("one byte", BLOCK_SIZE);
+
+	// Every short length, including those below a match
+	for (i = 0; i < BLOCK_SIZE; i++) in[i] = "abcabcabd"[rand() % 9];
+	for (length = 0; length < 300; length++)
+		failures += check("short block", length);
+
+	// Corrupt input is rejected instead of read past
+	for (length = 0; length < 64; length++){
+		for (i = 0; i < length; i++) packed[i] = rand();
+		decompressBlock(packed, length, out, 16);
+	}
+
+	printf("%d failures\n", failures);
+
+	return failures > 0;
+}
@@ -0,0 +1,11 @@
+// confidence.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the header of the function osssweep and ossbench use to
+// find the width of confidence intervals and the outcome of t-tests.
+
+#ifndef CONFIDENCE_H
+#define CONFIDENCE_H
+
+double tCritical(int degreesOfFreedom);
+
+#endif
@@ -20,6 +20,10 @@
 #define maxTimeBetweenNewProcsSecs 2U	// Value of seconds in max interval
 
 #define USER_PROG_PATH "./userProgram"	// The path to the user program
+#define USER_HOST_PATH "./userHost"	// Hosts user processes as coroutines
+#define HOST_MSG_TYPE (MAX_BLOCKS + 1)	// Type of messages to the host
+#define HOST_STACK_SIZE (64 * 1024)	// Stack of each hosted process
+#define QUANTUM_SIGNAL (SIGRTMIN + 1)	// Sent when a quantum runs out, -X
 
 #define REAL_TIME_PROBABILITY 0.1	// Probability new process is real time
 
@@ -28,7 +32,16 @@
 #define MAX_LOOP_INCREMENT_NS 1000	// Max nanosecond increment
 
 #define NUM_QUEUE_LEVELS 4		// Number of levels in multi-level queue
+#define QUEUE_CAPACITY 32		// Power of two, at least MAX_BLOCKS
+#define COMPLETION_RING_SIZE 32		// Power of two, replies held at once
+#define OUTPUT_QUEUE_CAPACITY 4096	// Power of two, log records in flight
+#define SPAWN_QUEUE_CAPACITY 32		// Power of two, children awaiting fork
+#define MAX_QUEUE_LEVELS 8		// Max levels settable with oss -l
 #define BASE_QUANTUM 10000000		// Base time quantum in nanoseconds
+#define QUANTUM_GAIN 0.05		// Step of adaptive burst estimates
+#define QUANTUM_RETUNE_BURSTS 32	// Bursts between adaptive retunes
+#define QUANTUM_RANGE 4			// Adaptive quanta stay within this
+					// factor of the fixed ones
 
 #define MIN_SCHEDULING_TIME_NS 100	// Min nanoseconds to schedule a process
 #define MAX_SCHEDULING_TIME_NS 1000	// Max nanoseconds to schedule a process
@@ -37,6 +50,9 @@
 
 #define MAX_TOTAL_GENERATED 100		// Max children launched by oss
 #define MAX_SECONDS 99999	 	// Max total execution time of oss
+#define CHECKPOINT_INTERVAL_SEC 10	// Simulated seconds between checkpoints
+#define MAX_LOCKSTEP_CONFIGS 8		// Configurations compared with -W
+#define LOCKSTEP_QUANTUM BASE_QUANTUM	// Quantum -W workloads are drawn for
 
 
 // Used by userProgram.c
@@ -48,11 +64,20 @@
 #define MAX_WAIT_SEC 3			// Max seconds waiting if blocked
 #define MAX_WAIT_MS 1000		// Max milliseconds waiting if blocked
 
+#define MAX_DEVICES 8			// Simulated I/O devices settable with -D
+#define DEVICE_NAME_SZ 16		// Size of a device name, with its '\0'
+
+#define WORKLOAD_CHUNK_US 20		// Cpu time spun between checks with -X
+#define WORKLOAD_IO_WAIT_US 50		// Wait between chunks of I/O bursts
+
 
 // Used by both oss.c and userProgram.c
 #define DISPATCH_MQ_KEY 59597192	// Message queue key for dispatch
 #define REPLY_MQ_KEY 38257848		// Message queue key for interrupts
 #define MQ_PERMS (S_IRUSR | S_IWUSR)	// Message queue permissions
+#define MAX_INSTANCES 4096		// Instance numbers are below this
+#define CONTROL_FIFO_FORMAT "/tmp/oss.%d.ctl" // Control FIFO, given instance
+#define HOUSEKEEPING_INTERVAL_MS 100	// Real time between log flushes
 
 #define BASE_SEED 8853984		// Used in calls to srand
 
@@ -62,6 +87,18 @@
 #define PREEMPT_CH 'p'			// Indicates process was preempted
 #define DELIM ' '			// Message text delimiter
 
+// Used by sweep.c
+#define OSS_PATH "./oss"		// The path to oss
+#define DEFAULT_SWEEP_SEEDS 5		// Seeds per grid point if none given
+#define MAX_SWEEP_PARAMS 8		// Max parameters varied in a sweep
+#define MAX_SWEEP_VALUES 32		// Max values of a swept parameter
+#define MAX_SWEEP_SEEDS 100		// Max seeds per grid point
+#define MAX_METRICS 32			// Max metrics read from a metrics file
+#define DEFAULT_BENCH_RUNS 5		// Seeds run per ossbench scenario
+#define MAX_BENCH_RUNS 100		// Max seeds per ossbench scenario
+#define BENCH_THRESHOLD 5		// Percent change ossbench flags
+
+
 // Used by bitVector.c
 #define NUM_BITS (sizeof(unsigned int) * 8)  // Bits per unsigned int
 #define MAX_VALUE (MAX_BLOCKS - 1) 	   // Max int tracked in bit vector
@@ -71,7 +108,8 @@
 // Used by multiQueue.c 
 #define PROMOTION_WAIT_TIME_THRESHOLD_NS 0 // Aging criterion for promotion sec
 #define PROMOTION_WAIT_TIME_THRESHOLD_SEC MAX_BLOCKS // Aging criterion seconds
-#define UTIL_THRESHOLD (1 / (long double) multiQ->count) // Cpu use criterion
+#define UTIL_THRESHOLD (params.utilThresholdScale \
+			/ (long double) multiQ->count) // Cpu use criterion
 
 #define WAKE_UP_INCREMENT_SEC 0		// Blocked process wake-up seconds
 #define WAKE_UP_INCREMENT_NS 100	// Blocked process wake-up nanosecodns
@@ -82,7 +120,15 @@
 #define MILLION 1000000U		// Number of nanoseconds per millisecond
 #define BUFF_SZ 100			// The size of character buffers 
 #define MSG_SZ 30			// Size of Message char arrays
-
-#define MAX_LOG_LINES 10000		// Max number of lines in the log file
+#define CACHE_LINE_SIZE 64		// Bytes per cpu cache line
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024) // Bytes per hugetlb page
+#define SHM_NAME_FORMAT "/oss.%d"	// POSIX shm name, given the instance
+
+#define LOG_BUFFER_SIZE 65536		// Bytes written to the log at once
+#define LOG_BUFFER_ALIGN 4096		// Alignment of the log buffer
+#define LOG_SEGMENT_FORMAT "%s.%06d"	// Log path and segment number
+#define LOG_MAGIC "OSZ1"		// Starts each compressed log segment
+#define LOG_MAGIC_SIZE 4
+#define LOG_BLOCK_STORED 0x40000000	// Marks a block stored uncompressed
 
 #endif
@@ -0,0 +1,220 @@
+// device.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that simulate the I/O devices
+// given with -D.
+//
+// A process whose burst ends waiting for a device joins the device's queue,
+// and counts as blocked in the MultiQueue from then on. A device serves one
+// request at a time: when it starts one, it draws the service time from a
+// generator of its own, adds the time the head takes to reach the request's
+// track, and puts the process in the blocked queue until the service ends, so
+// checkBlockedProcesses wakes it as it wakes any other. A FIFO device serves
+// requests in the order they came, and an elevator serves the nearest track
+// in the direction the head is moving, turning when there is none.
+//
+// Devices are advanced to the time of each request and of each check for
+// wake-ups, and a device that finished a service by then starts the next at
+// the time it finished, so the services don't depend on when oss looks.
+
+#include <stdio.h>
+
+#include "constants.h"
+#include "device.h"
+#include "logging.h"
+#include "parameters.h"
+#include "perrorExit.h"
+#include "queue.h"
+#include "randomGen.h"
+
+typedef struct device {
+	Queue waiting;			// Processes not yet served
+	int busy;			// Nonzero while serving a process
+	Clock busyUntil;		// End of the service, while busy
+	int head;			// Track the head is over
+	int direction;			// 1 while moving up the tracks, else -1
+	RandomGenerator generator;	// Draws service times of this device
+
+	// Counted from the beginning of the measurement
+	long requests;			// Services started
+	Clock busyTime;			// Time spent serving them
+	Clock queueDelay;		// Time they waited before service
+} Device;
+
+static Device devices[MAX_DEVICES];
+static Clock measureStart;		// Time the measurement began
+
+// Sets every device idle and seeds each off the seed of the run
+void openDevices(){
+	int i;
+
+	for (i = 0; i < params.numDevices; i++){
+		initializeQueue(&devices[i].waiting);
+		devices[i].busy = 0;
+		devices[i].head = 0;
+		devices[i].direction = 1;
+		seedRandomGenerator(&devices[i].generator, params.seed + i);
+	}
+
+	beginDeviceMeasurement(zeroClock());
+}
+
+// Returns the position in the queue of the request a device serves next
+static int nextRequest(Device * device){
+	int i, turns, distance, best, bestDistance = 0;
+
+	// FIFO devices serve the front of the queue
+	if (params.devices[device - devices].discipline == FIFO_DEVICE)
+		return 0;
+
+	// Finds the nearest track ahead of the head, turning if none is
+	for (turns = 0; turns < 2; turns++){
+		best = -1;
+		for (i = 0; i < device->waiting.count; i++){
+			distance = (pcbAccounting(queueAt(&device->waiting, i))
+				    ->ioTrack - device->head)
+				   * device->direction;
+			if (distance >= 0
+			    && (best == -1 || distance < bestDistance)){
+				best = i;
+				bestDistance = distance;
+			}
+		}
+		if (best != -1) return best;
+		device->direction = -device->direction;
+	}
+
+	perrorExit("device.c - no request to serve");
+}
+
+// Starts serving the next request of an idle device at time start
+static void startService(MultiQueue * q, int index, Clock start){
+	Device * device = &devices[index];
+	const DeviceSpec * spec = &params.devices[index];
+	RandomGenerator * previous = currentRandomGenerator();
+	ProcessControlBlock * pcb;
+	ProcessAccounting * accounting;
+	unsigned long long seekNs;
+	Clock service;
+	int distance;
+
+	pcb = removeFromQueue(&device->waiting, nextRequest(device));
+	accounting = pcbAccounting(pcb);
+
+	// Draws the service time, then adds the seek to the track
+	useRandomGenerator(&device->generator);
+	service = randomTime(spec->minService, spec->maxService);
+	useRandomGenerator(previous);
+
+	distance = accounting->ioTrack - device->head;
+	seekNs = (unsigned long long) (distance < 0 ? -distance : distance)
+		 * spec->seekNs;
+	incrementClock(&service, newClock(seekNs / BILLION, seekNs % BILLION));
+	device->head = accounting->ioTrack;
+
+	device->busy = 1;
+	device->busyUntil = clockSum(start, service);
+	device->requests++;
+	incrementClock(&device->busyTime, service);
+	incrementClock(&device->queueDelay,
+		       clockDiff(start, accounting->ioRequestTime));
+
+	// Blocks the process until the service ends
+	pcb->nextIoEventTime = device->busyUntil;
+	mAddToBlockedQueue(&q->blockedQueue, pcb);
+	logDeviceService(pcb->simPid, index, device->busyUntil);
+}
+
+// Ends the services of a device that finish by now, starting the next of each
+// at the time the last one ended
+static void advanceDevice(MultiQueue * q, int index, Clock now){
+	Device * device = &devices[index];
+
+	while (device->busy && clockCompare(device->busyUntil, now) <= 0){
+		device->busy = 0;
+		if (device->waiting.count > 0)
+			startService(q, index, device->busyUntil);
+	}
+}
+
+// Advances every device to now
+void advanceDevices(MultiQueue * q, Clock now){
+	int i;
+
+	for (i = 0; i < params.numDevices; i++)
+		advanceDevice(q, i, now);
+}
+
+// Blocks pcb waiting for a device to serve track, from time on
+void requestDevice(MultiQueue * q, ProcessControlBlock * pcb, int index,
+		   int track, Clock time){
+	Device * device;
+
+	if (index < 0 || index >= params.numDevices)
+		perrorExit("device.c - request names no device");
+	device = &devices[index];
+
+	pcb->state = BLOCKED;
+	pcbAccounting(pcb)->ioTrack = track;
+	pcbAccounting(pcb)->ioRequestTime = time;
+	q->count++;
+	q->blockedCount++;
+	logDeviceRequest(pcb->simPid, index, time);
+
+	// Serves the request at once if the device is idle by then
+	advanceDevice(q, index, time);
+	enqueue(&device->waiting, pcb);
+	if (!device->busy)
+		startService(q, index, time);
+}
+
+// Restarts the counts of every device at time, keeping the part of a service
+// in progress that comes after it
+void beginDeviceMeasurement(Clock time){
+	Device * device;
+	int i;
+
+	measureStart = time;
+	for (i = 0; i < params.numDevices; i++){
+		device = &devices[i];
+		device->requests = 0;
+		device->queueDelay = zeroClock();
+		device->busyTime = device->busy
+				   && clockCompare(device->busyUntil, time) > 0
+				   ? clockDiff(device->busyUntil, time)
+				   : zeroClock();
+	}
+}
+
+// Returns a clock in seconds
+static double seconds(Clock time){
+	return time.seconds + time.nanoseconds / (double) BILLION;
+}
+
+// Prints the utilization, mean queueing delay and requests of each device
+// from the beginning of the measurement to endTime
+void printDeviceMetrics(FILE * fp, Clock endTime){
+	const Device * device;
+	double busy, elapsed;
+	int i;
+
+	elapsed = seconds(clockDiff(endTime, measureStart));
+	for (i = 0; i < params.numDevices; i++){
+		device = &devices[i];
+
+		// Leaves out the part of a service in progress after endTime
+		busy = seconds(device->busyTime);
+		if (device->busy
+		    && clockCompare(device->busyUntil, endTime) > 0)
+			busy -= seconds(clockDiff(device->busyUntil, endTime));
+
+		fprintf(fp, "device_%s_utilization %.6f\n",
+			params.devices[i].name,
+			elapsed > 0 ? busy / elapsed : 0);
+		fprintf(fp, "device_%s_mean_queue_delay %.9f\n",
+			params.devices[i].name,
+			device->requests > 0
+			? seconds(device->queueDelay) / device->requests : 0);
+		fprintf(fp, "device_%s_requests %ld\n", params.devices[i].name,
+			device->requests);
+	}
+}
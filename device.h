@@ -0,0 +1,23 @@
+// device.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions that simulate the I/O devices
+// given with -D, each serving the processes blocked on it one at a time from
+// a queue of its own.
+
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdio.h>
+
+#include "clock.h"
+#include "multiQueue.h"
+#include "pcb.h"
+
+void openDevices();
+void requestDevice(MultiQueue * q, ProcessControlBlock * pcb, int device,
+		   int track, Clock time);
+void advanceDevices(MultiQueue * q, Clock now);
+void beginDeviceMeasurement(Clock time);
+void printDeviceMetrics(FILE * fp, Clock endTime);
+
+#endif
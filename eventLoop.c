@@ -0,0 +1,222 @@
+// eventLoop.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that gather the sources of work
+// of oss in one epoll instance. User processes ring an eventfd doorbell after
+// sending a reply, since SysV message queues can't be polled. Each child's
+// exit is watched through a pidfd, a timerfd paces housekeeping, and a FIFO
+// accepts one-line control commands. With -X, the signal quantum timers send
+// is blocked and read from a signalfd.
+//
+// Sources with a fixed type are registered with the type as their epoll data.
+// A pidfd is registered with its pid in the upper half and the descriptor in
+// the lower, so its data is never a plain type.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "eventLoop.h"
+#include "perrorExit.h"
+
+#define MAX_EVENTS (MAX_BLOCKS + 4)	// Events taken from one epoll_wait
+
+static int epollFd = -1;	// The epoll instance
+static int doorbellFd = -1;	// eventfd rung by children after replying
+static int timerFd = -1;	// Periodic housekeeping timer
+static int controlFd = -1;	// Read end of the control FIFO
+static int signalFd = -1;	// Receives QUANTUM_SIGNAL, with -X
+static const char * controlFifo = NULL; // Path of the control FIFO
+
+static struct epoll_event pending[MAX_EVENTS]; // Events not yet returned
+static int numPending = 0;
+static int nextPending = 0;
+
+static char commands[BUFF_SZ];	// Control input not yet split into lines
+static int commandsLength = 0;
+
+// Adds a descriptor to the epoll instance with the given data
+static void watch(int fd, uint64_t data){
+	struct epoll_event event;
+
+	event.events = EPOLLIN;
+	event.data.u64 = data;
+
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+		perrorExit("eventLoop.c - failed to add to epoll");
+}
+
+// Creates the epoll instance and its sources, with a control FIFO at path
+void openEventLoop(const char * controlPath){
+	struct itimerspec interval;
+
+	if ((epollFd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+		perrorExit("eventLoop.c - failed to create epoll instance");
+
+	// Leaves the doorbell open across exec so children can ring it
+	if ((doorbellFd = eventfd(0, EFD_NONBLOCK)) == -1)
+		perrorExit("eventLoop.c - failed to create doorbell");
+	watch(doorbellFd, REPLY_EVENT);
+
+	// Fires every HOUSEKEEPING_INTERVAL_MS of real time
+	timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (timerFd == -1)
+		perrorExit("eventLoop.c - failed to create timer");
+	interval.it_interval.tv_sec = 0;
+	interval.it_interval.tv_nsec = HOUSEKEEPING_INTERVAL_MS * MILLION;
+	interval.it_value = interval.it_interval;
+	if (timerfd_settime(timerFd, 0, &interval, NULL) == -1)
+		perrorExit("eventLoop.c - failed to set timer");
+	watch(timerFd, TIMER_EVENT);
+
+	// Opened for writing too, so the FIFO never reports end of file
+	if (mkfifo(controlPath, 0600) == -1 && errno != EEXIST)
+		perrorExit("eventLoop.c - failed to create control FIFO");
+	controlFifo = controlPath;
+	if ((controlFd = open(controlPath, O_RDWR | O_NONBLOCK | O_CLOEXEC))
+	    == -1)
+		perrorExit("eventLoop.c - failed to open control FIFO");
+	watch(controlFd, CONTROL_EVENT);
+}
+
+// Returns the descriptor children ring after sending a reply
+int replyDoorbell(){
+	return doorbellFd;
+}
+
+// Wakes oss from nextEvent, called by a child after replying
+void ringDoorbell(int doorbell){
+	uint64_t one = 1;
+
+	if (write(doorbell, &one, sizeof(one)) != sizeof(one))
+		perrorExit("eventLoop.c - failed to ring doorbell");
+}
+
+// Reports an EXIT_EVENT when the process with pid exits
+void watchChildExit(pid_t pid){
+	int pidFd = syscall(SYS_pidfd_open, pid, 0);
+
+	if (pidFd == -1)
+		perrorExit("eventLoop.c - failed to open pidfd");
+
+	fcntl(pidFd, F_SETFD, FD_CLOEXEC);
+	watch(pidFd, (uint64_t) pid << 32 | (uint32_t) pidFd);
+}
+
+// Reports a QUANTUM_EVENT for each QUANTUM_SIGNAL, which is blocked so only
+// the signalfd receives it
+void watchQuantumSignal(){
+	sigset_t quantum;
+
+	sigemptyset(&quantum);
+	sigaddset(&quantum, QUANTUM_SIGNAL);
+	if (sigprocmask(SIG_BLOCK, &quantum, NULL) == -1)
+		perrorExit("eventLoop.c - failed to block quantum signal");
+
+	signalFd = signalfd(-1, &quantum, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (signalFd == -1)
+		perrorExit("eventLoop.c - failed to create signalfd");
+	watch(signalFd, QUANTUM_EVENT);
+}
+
+// Gets the next event, waiting up to timeoutMs (-1 for ever), returning 0 on
+// timeout or when a signal is caught
+int nextEvent(Event * event, int timeoutMs){
+	struct signalfd_siginfo info;
+	uint64_t data, count;
+
+	// Waits for more events once all pending ones are returned
+	if (nextPending == numPending){
+		numPending = epoll_wait(epollFd, pending, MAX_EVENTS,
+					timeoutMs);
+
+		// Returns as on a timeout, so the caller can act on the signal
+		if (numPending == -1 && errno == EINTR)
+			numPending = 0;
+		if (numPending == -1)
+			perrorExit("eventLoop.c - epoll_wait failed");
+
+		nextPending = 0;
+		if (numPending == 0) return 0;
+	}
+
+	data = pending[nextPending++].data.u64;
+
+	// Closes the pidfd of an exited child, removing it from epoll
+	if (data >> 32 != 0){
+		event->type = EXIT_EVENT;
+		event->pid = data >> 32;
+		close((int) (uint32_t) data);
+		return 1;
+	}
+
+	// Resets the counters of the doorbell and timer
+	event->type = data;
+	if (event->type == REPLY_EVENT)
+		read(doorbellFd, &count, sizeof(count));
+	else if (event->type == TIMER_EVENT)
+		read(timerFd, &count, sizeof(count));
+
+	// Takes one signal, leaving the rest for later calls
+	else if (event->type == QUANTUM_EVENT){
+		if (read(signalFd, &info, sizeof(info)) != sizeof(info))
+			return nextEvent(event, timeoutMs);
+		event->burst = info.ssi_int;
+	}
+
+	return 1;
+}
+
+// Copies the next line written to the control FIFO, returning 0 if none
+int readControlCommand(char * command, int size){
+	ssize_t bytes;
+	char * newline;
+	int length;
+
+	// Reads whatever fits after input left from earlier calls
+	bytes = read(controlFd, commands + commandsLength,
+		     sizeof(commands) - commandsLength - 1);
+	if (bytes > 0) commandsLength += bytes;
+	commands[commandsLength] = '\0';
+
+	// Discards input too long to be a command
+	if ((newline = strchr(commands, '\n')) == NULL){
+		if (commandsLength == sizeof(commands) - 1)
+			commandsLength = 0;
+		return 0;
+	}
+
+	// Copies the line and shifts the rest of the input forward
+	length = newline - commands;
+	if (length >= size) length = size - 1;
+	memcpy(command, commands, length);
+	command[length] = '\0';
+
+	commandsLength -= newline + 1 - commands;
+	memmove(commands, newline + 1, commandsLength);
+
+	return 1;
+}
+
+// Closes the sources and removes the control FIFO
+void closeEventLoop(){
+	if (epollFd == -1) return;
+
+	close(epollFd);
+	close(doorbellFd);
+	close(timerFd);
+	close(controlFd);
+	if (signalFd != -1) close(signalFd);
+	unlink(controlFifo);
+	epollFd = -1;
+}
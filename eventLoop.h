@@ -0,0 +1,36 @@
+// eventLoop.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the Event type and headers for
+// functions that let oss wait on every source of work at once with epoll:
+// replies from user processes, their exits, a housekeeping timer, commands
+// written to its control FIFO and, with -X, the ends of quanta.
+
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <sys/types.h>
+
+typedef enum EventType {
+	REPLY_EVENT,	// A user process rang the reply doorbell
+	EXIT_EVENT,	// A user process exited
+	TIMER_EVENT,	// The housekeeping timer expired
+	CONTROL_EVENT,	// Commands were written to the control FIFO
+	QUANTUM_EVENT	// A quantum timer expired
+} EventType;
+
+typedef struct event {
+	EventType type;
+	pid_t pid;		// The process that exited, for EXIT_EVENT
+	unsigned int burst;	// Burst of the timer, for QUANTUM_EVENT
+} Event;
+
+void openEventLoop(const char * controlPath);
+int replyDoorbell();
+void ringDoorbell(int doorbell);
+void watchChildExit(pid_t pid);
+void watchQuantumSignal();
+int nextEvent(Event * event, int timeoutMs);
+int readControlCommand(char * command, int size);
+void closeEventLoop();
+
+#endif
@@ -1,27 +1,112 @@
 // getSharedMemoryPointers.c was created by Mark Renard on 3/27/2020.
 //
-// This file contains definitions for a shared memory function specific to
-// assignment 4. This function is used by oss.c and userProcess.c.
+// This file contains definitions for shared memory functions specific to
+// assignment 4. These functions are used by oss.c, userProcess.c and top.c.
+//
+// The region holds the system clock, published under a seqlock (sharedClock.h)
+// on a cache line of its own, the process control blocks, one cache line
+// each, the accounting records, the multi-level queue and the completion ring,
+// followed by the stats page on a page boundary of its own so publishing it
+// doesn't disturb the cache lines children read.
+//
+// oss creates the region with the backend chosen by its -B option. Children
+// of a POSIX or memfd region map the descriptor they inherit, and osstop
+// finds a region by its SysV key or POSIX name.
+
+#include <stdio.h>
+#include <unistd.h>
 
 #include "constants.h"
 #include "clock.h"
+#include "completionRing.h"
+#include "multiQueue.h"
+#include "parameters.h"
 #include "pcb.h"
+#include "sharedClock.h"
 #include "sharedMemory.h"
+#include "shmkey.h"
+#include "statsPage.h"
+
+// Returns the name of the POSIX shared memory object of this instance
+static const char * shmName(){
+	static char name[BUFF_SZ];
+
+	sprintf(name, SHM_NAME_FORMAT, params.instance);
+
+	return name;
+}
+
+// Returns the offset of the multi-level queue in the shared memory region
+static int multiQueueOffset(){
+	int tableEnd = CACHE_LINE_SIZE + sizeof(ProcessControlBlock) * MAX_BLOCKS
+		       + sizeof(ProcessAccounting) * MAX_BLOCKS;
+
+	return (tableEnd + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE
+	       * CACHE_LINE_SIZE;
+}
+
+// Returns the offset of the completion ring in the shared memory region
+static int completionRingOffset(){
+	int queueEnd = multiQueueOffset() + sizeof(MultiQueue);
+
+	return (queueEnd + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE
+	       * CACHE_LINE_SIZE;
+}
 
-void getSharedMemoryPointers(char ** shm,  Clock ** systemClock,
+// Returns the offset of the stats page in the shared memory region
+static int statsPageOffset(){
+	int pageSize = sysconf(_SC_PAGESIZE);
+	int ringEnd = completionRingOffset() + sizeof(CompletionRing);
+
+	return (ringEnd + pageSize - 1) / pageSize * pageSize;
+}
+
+void getSharedMemoryPointers(char ** shm, SharedClock ** systemClock,
 			     ProcessControlBlock ** processTable, int flags) {
 	// Computes size of the shared memory region
-	int shmSize = sizeof(ProcessControlBlock) * MAX_BLOCKS \
-                      + sizeof(Clock);
+	int shmSize = statsPageOffset() + sizeof(StatsPage);
 
-	// Attaches to shared memory
-        *shm = sharedMemory(shmSize, flags);
+	// Maps an inherited region, creates a mapped one, or attaches by key
+	if (params.shmFd >= 0)
+		*shm = attachSharedMemoryFd(params.shmFd);
+	else if ((flags & IPC_CREAT) && params.shmBackend == POSIX_SHM)
+		*shm = mappedSharedMemory(shmName(), shmSize,
+					  params.shmOptions);
+	else if ((flags & IPC_CREAT) && params.shmBackend == MEMFD_SHM)
+		*shm = mappedSharedMemory(NULL, shmSize, params.shmOptions);
+	else
+		*shm = sharedMemory(instanceKey(SHMKEY), shmSize, flags);
 
 	// Gets pointer to simulated system clock
-	*systemClock = (Clock *) *shm;
+	*systemClock = (SharedClock *) *shm;
 
 	// Gets pointer to first process control block
-	*processTable = (ProcessControlBlock *) (*shm + sizeof(Clock));
+	*processTable = (ProcessControlBlock *) (*shm + CACHE_LINE_SIZE);
+
+	// Accounting records follow the process control blocks
+	setProcessTable(*processTable,
+			(ProcessAccounting *) (*processTable + MAX_BLOCKS));
+
+}
 
+// Returns a pointer to the multi-level queue in an attached region
+MultiQueue * getMultiQueue(char * shm){
+	return (MultiQueue *) (shm + multiQueueOffset());
 }
 
+// Returns a pointer to the completion ring in an attached region
+CompletionRing * getCompletionRing(char * shm){
+	return (CompletionRing *) (shm + completionRingOffset());
+}
+
+// Returns a pointer to the stats page in an attached shared memory region
+StatsPage * getStatsPage(char * shm){
+	return (StatsPage *) (shm + statsPageOffset());
+}
+
+// Attaches to an existing region read-only, for monitoring
+char * attachStatsReadOnly(){
+	char * shm = sharedMemoryReadOnly(instanceKey(SHMKEY));
+
+	return shm != NULL ? shm : mappedSharedMemoryReadOnly(shmName());
+}
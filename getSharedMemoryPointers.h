@@ -8,8 +8,16 @@
 
 #include "pcb.h"
 #include "clock.h"
+#include "completionRing.h"
+#include "multiQueue.h"
+#include "sharedClock.h"
+#include "statsPage.h"
 
-void getSharedMemoryPointers(char ** shm,  Clock ** systemClock,
+void getSharedMemoryPointers(char ** shm, SharedClock ** systemClock,
                              ProcessControlBlock ** processTable, int flags);
+MultiQueue * getMultiQueue(char * shm);
+CompletionRing * getCompletionRing(char * shm);
+StatsPage * getStatsPage(char * shm);
+char * attachStatsReadOnly();
 
 #endif
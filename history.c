@@ -0,0 +1,162 @@
+// history.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that keep the history of every
+// burst of each process lifetime and write it out for offline analysis.
+//
+// The arena is mapped and touched once when the history is opened, so a
+// burst never allocates: its record goes in the last chunk of its simPid's
+// list, which takes a chunk from the free list, or the next never-used chunk,
+// when it is full. When a simPid is freed its lifetime is written to the
+// history file and its whole list is spliced onto the free list at once. If
+// the arena runs out, records are counted as dropped rather than kept.
+
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include "constants.h"
+#include "history.h"
+#include "perrorExit.h"
+
+#define HISTORY_BUFFER_SIZE (1 << 20)
+
+typedef struct historyChunk {
+	int next;		// Index of the next chunk in its list, or -1
+	int count;		// Records used in this chunk
+	char unused[8];		// Pads the header to one record
+	BurstRecord records[HISTORY_CHUNK_RECORDS];
+} HistoryChunk;
+
+typedef struct history {
+	long lifetime;		// Number of the lifetime, or -1 if none
+	int head;		// First chunk of the lifetime, or -1
+	int tail;		// Chunk records are appended to, or -1
+} History;
+
+_Static_assert(sizeof(HistoryChunk) == 512,
+	       "HistoryChunk should fill eight cache lines");
+
+static FILE * out = NULL;		// File the histories are written to
+static HistoryChunk * arena;		// Preallocated chunks
+static int bumped = 0;			// Chunks ever handed out
+static int freeChunks = -1;		// First recycled chunk, or -1
+static History histories[MAX_BLOCKS];	// Lifetime of each simPid
+static long lifetimes = 0;		// Lifetimes begun
+static long dropped = 0;		// Records lost to a full arena
+
+// Maps the arena and creates the history file at path
+void openHistory(const char * path){
+	int i;
+
+	arena = mmap(NULL, sizeof(HistoryChunk) * HISTORY_ARENA_CHUNKS,
+		     PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+	if (arena == MAP_FAILED)
+		perrorExit("history.c - failed to map arena");
+
+	if ((out = fopen(path, "w")) == NULL)
+		perrorExit("history.c - failed to open history file");
+	setvbuf(out, NULL, _IOFBF, HISTORY_BUFFER_SIZE);
+	fprintf(out, "lifetime sim_pid dispatch_time level used_ns outcome\n");
+
+	for (i = 0; i < MAX_BLOCKS; i++)
+		histories[i] = (History) {-1, -1, -1};
+}
+
+// Starts an empty history for the lifetime just given simPid
+void beginHistory(int simPid){
+	if (out == NULL) return;
+
+	histories[simPid] = (History) {lifetimes++, -1, -1};
+}
+
+// Returns a free chunk, reusing recycled ones first, or -1 if there is none
+static int takeChunk(){
+	int chunk = freeChunks;
+
+	if (chunk != -1)
+		freeChunks = arena[chunk].next;
+	else if (bumped < HISTORY_ARENA_CHUNKS)
+		chunk = bumped++;
+	else
+		return -1;
+
+	arena[chunk].next = -1;
+	arena[chunk].count = 0;
+
+	return chunk;
+}
+
+// Appends a burst to the history of simPid
+void recordBurst(int simPid, Clock dispatchTime, int level,
+		 unsigned int usedNano, char outcome){
+	History * history = &histories[simPid];
+	HistoryChunk * tail;
+	int chunk;
+
+	if (out == NULL) return;
+
+	// Links a new chunk once the last one is full
+	if (history->tail == -1
+	    || arena[history->tail].count == HISTORY_CHUNK_RECORDS){
+		if ((chunk = takeChunk()) == -1){
+			dropped++;
+			return;
+		}
+		if (history->tail == -1)
+			history->head = chunk;
+		else
+			arena[history->tail].next = chunk;
+		history->tail = chunk;
+	}
+
+	tail = &arena[history->tail];
+	tail->records[tail->count++] = (BurstRecord) {dispatchTime, usedNano,
+						      level, outcome};
+}
+
+// Writes the history of simPid and returns its chunks to the arena
+void releaseHistory(int simPid){
+	History * history = &histories[simPid];
+	const BurstRecord * record;
+	int chunk, i;
+
+	if (out == NULL || history->lifetime == -1) return;
+
+	for (chunk = history->head; chunk != -1; chunk = arena[chunk].next){
+		for (i = 0; i < arena[chunk].count; i++){
+			record = &arena[chunk].records[i];
+			fprintf(out, "%ld %d %u.%09u %u %u %c\n",
+				history->lifetime, simPid,
+				record->dispatchTime.seconds,
+				record->dispatchTime.nanoseconds,
+				record->level, record->usedNano,
+				record->outcome);
+		}
+	}
+
+	// Splices the whole list onto the free list
+	if (history->head != -1){
+		arena[history->tail].next = freeChunks;
+		freeChunks = history->head;
+	}
+
+	*history = (History) {-1, -1, -1};
+}
+
+// Writes the histories of processes still in the system and closes the file
+void closeHistory(){
+	int i;
+
+	if (out == NULL) return;
+
+	for (i = 0; i < MAX_BLOCKS; i++)
+		releaseHistory(i);
+
+	if (dropped > 0)
+		fprintf(stderr, "%s: history arena full, %ld bursts not"
+			" recorded\n", exeName, dropped);
+
+	fclose(out);
+	out = NULL;
+	munmap(arena, sizeof(HistoryChunk) * HISTORY_ARENA_CHUNKS);
+}
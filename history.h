@@ -0,0 +1,31 @@
+// history.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the BurstRecord type and headers for
+// functions that keep the burst-by-burst history of each process lifetime.
+// Records are appended to chunks taken from one preallocated arena, and a
+// lifetime's chunks go back to the arena together when its simPid is freed,
+// after its history is written out.
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "clock.h"
+
+#define HISTORY_CHUNK_RECORDS 31	// Records in one chunk of the arena
+#define HISTORY_ARENA_CHUNKS 4096	// Chunks preallocated in the arena
+
+typedef struct burstRecord {
+	Clock dispatchTime;		// Time the burst was dispatched
+	unsigned int usedNano;		// Nanoseconds of the quantum used
+	unsigned char level;		// Queue level dispatched from
+	char outcome;			// State character of the reply
+} BurstRecord;
+
+void openHistory(const char * path);
+void beginHistory(int simPid);
+void recordBurst(int simPid, Clock dispatchTime, int level,
+		 unsigned int usedNano, char outcome);
+void releaseHistory(int simPid);
+void closeHistory();
+
+#endif
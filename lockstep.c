@@ -0,0 +1,327 @@
+// lockstep.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that run a what-if comparison
+// of scheduler configurations with common random numbers.
+//
+// oss generates the whole workload once, before forking: the class of each
+// process and the gap to the next arrival, and every burst of each process,
+// from termination to termination, as simulateBurst replies to a quantum of
+// LOCKSTEP_QUANTUM. It then forks a child for the configuration on its
+// command line and one for each -W, which applies its options on top. Each
+// child simulates its configuration in-process with a clock of its own,
+// taking arrivals and bursts from the workload in order and scaling the time
+// of each burst to the quantum it was given, so a process terminates, blocks
+// or is preempted on the same burst in every configuration. When all the
+// children have exited oss prints their metrics as a table with a column per
+// configuration.
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "burst.h"
+#include "constants.h"
+#include "lockstep.h"
+#include "parameters.h"
+#include "perrorExit.h"
+#include "randomGen.h"
+
+typedef struct lockstepProcess {
+	SchedulingClass schedulingClass;
+	Clock gap;			// Time from its arrival to the next
+	int firstBurst;			// Index of its first burst in bursts
+} LockstepProcess;
+
+// Metrics printed in the table, in order
+static const char * tableMetrics[] = {
+	"throughput", "cpu_utilization", "dispatches", "full_quanta",
+	"preemptions", "mean_wait", "mean_turnaround", "turnaround_p50",
+	"turnaround_p90", "turnaround_p99", "mean_response", "response_p50",
+	"response_p90", "response_p99"
+};
+static const int numTableMetrics = sizeof(tableMetrics) / sizeof(char *);
+
+// Metrics of each device with -D, whose names end with these, in order
+static const char * deviceMetrics[] = {"_utilization", "_mean_queue_delay"};
+#define NUM_DEVICE_METRICS 2
+
+static LockstepProcess processes[MAX_TOTAL_GENERATED];
+static char (* bursts)[MSG_SZ] = NULL;	// Replies of every burst
+static int numBursts = 0;
+static int burstCapacity = 0;
+
+static int nextArrival = 0;		// Lifetime of the next arrival
+static int nextBurst[MAX_BLOCKS];	// Index of each simPid's next burst
+
+static char metricsPaths[MAX_LOCKSTEP_CONFIGS + 1][PATH_MAX];
+static char logPath[PATH_MAX], tracePath[PATH_MAX], historyPath[PATH_MAX];
+static char sketchPath[PATH_MAX];
+
+// Appends a reply to the bursts of the workload
+static void addBurst(const char * reply){
+	if (numBursts == burstCapacity){
+		burstCapacity = burstCapacity > 0 ? burstCapacity * 2 : 256;
+		bursts = realloc(bursts, burstCapacity * sizeof(*bursts));
+		if (bursts == NULL)
+			perrorExit("lockstep.c - failed to allocate bursts");
+	}
+
+	memcpy(bursts[numBursts++], reply, MSG_SZ);
+}
+
+// Draws every arrival and burst of the run
+static void generateWorkload(){
+	RandomGenerator * previous = currentRandomGenerator();
+	RandomGenerator arrivals, process;
+	char reply[MSG_SZ];
+	int i, finished;
+
+	seedRandomGenerator(&arrivals, params.seed - 2);
+
+	for (i = 0; i < MAX_TOTAL_GENERATED; i++){
+		useRandomGenerator(&arrivals);
+		processes[i].schedulingClass =
+			randBinary(params.realTimeProbability)
+			? REAL_TIME : NORMAL;
+		processes[i].gap = randomTime(zeroClock(),
+					      params.maxArrivalGap);
+		processes[i].firstBurst = numBursts;
+
+		// Runs the process's bursts until the one it terminates in
+		seedRandomGenerator(&process, params.seed + i);
+		useRandomGenerator(&process);
+		do {
+			sprintf(reply, "%u", LOCKSTEP_QUANTUM);
+			finished = simulateBurst(reply);
+			addBurst(reply);
+		} while (!finished);
+	}
+
+	useRandomGenerator(previous);
+}
+
+// Copies path with the column appended into buff, or leaves it NULL
+static char * columnPath(char * buff, const char * path, int column){
+	if (path == NULL) return NULL;
+
+	snprintf(buff, PATH_MAX, "%s.%d", path, column);
+
+	return buff;
+}
+
+// Applies the options of a configuration, exiting if they change the
+// workload, which was drawn with the settings of the command line. Devices
+// given replace those of the command line, and must be as many.
+static void applyConfig(const char * config){
+	Parameters given = params;
+	char * argv[BUFF_SZ];
+	char * copy, * token;
+	int argc = 0;
+
+	if ((copy = strdup(config)) == NULL)
+		perrorExit("lockstep.c - failed to copy configuration");
+
+	argv[argc++] = exeName;
+	for (token = strtok(copy, " "); token != NULL && argc < BUFF_SZ - 1;
+	     token = strtok(NULL, " "))
+		argv[argc++] = token;
+	argv[argc] = NULL;
+
+	optind = 1;
+	params.numDevices = 0;
+	parseParameters(argc, argv);
+	if (params.numDevices == 0){
+		memcpy(params.devices, given.devices, sizeof(given.devices));
+		params.numDevices = given.numDevices;
+	}
+
+	if (params.seed != given.seed
+	    || params.realTimeProbability != given.realTimeProbability
+	    || params.interruptProbability != given.interruptProbability
+	    || clockCompare(params.maxArrivalGap, given.maxArrivalGap) != 0
+	    || params.numDevices != given.numDevices
+	    || params.numLockstepConfigs != given.numLockstepConfigs){
+		fprintf(stderr, "%s: -W '%s' changes the workload\n", exeName,
+			config);
+		exit(1);
+	}
+}
+
+// Sets up the child simulating a column of the table
+static void beginColumn(int column){
+	if (column > 0)
+		applyConfig(params.lockstepConfigs[column - 1]);
+
+	// Keeps the IPC objects and output files of columns apart
+	if (params.instance != AUTO_INSTANCE)
+		params.instance = (params.instance + column) % MAX_INSTANCES;
+	params.logPath = columnPath(logPath, params.logPath, column);
+	params.tracePath = columnPath(tracePath, params.tracePath, column);
+	params.historyPath = columnPath(historyPath, params.historyPath,
+					column);
+	params.sketchPath = columnPath(sketchPath, params.sketchPath, column);
+	params.metricsPath = metricsPaths[column];
+}
+
+// Returns nonzero if name is a device metric ending with suffix
+static int isDeviceMetric(const char * name, const char * suffix){
+	int length = strlen(name), suffixLength = strlen(suffix);
+
+	return strncmp(name, "device_", 7) == 0 && length > suffixLength
+	       && strcmp(name + length - suffixLength, suffix) == 0;
+}
+
+// Reads the value of each table metric from a metrics file, then those of
+// each device in the order they appear, returning 0 if the file can't be read
+static int readColumn(const char * path, double * values){
+	int devices[NUM_DEVICE_METRICS] = {0}; // Devices read of each metric
+	char name[BUFF_SZ];
+	double value;
+	FILE * fp;
+	int i;
+
+	if ((fp = fopen(path, "r")) == NULL) return 0;
+
+	for (i = 0; i < numTableMetrics + NUM_DEVICE_METRICS * MAX_DEVICES; i++)
+		values[i] = 0;
+
+	while (fscanf(fp, "%99s %lf", name, &value) == 2){
+		for (i = 0; i < numTableMetrics; i++)
+			if (strcmp(name, tableMetrics[i]) == 0)
+				values[i] = value;
+		for (i = 0; i < NUM_DEVICE_METRICS; i++)
+			if (isDeviceMetric(name, deviceMetrics[i])
+			    && devices[i] < MAX_DEVICES)
+				values[numTableMetrics
+				       + devices[i]++ * NUM_DEVICE_METRICS + i]
+					= value;
+	}
+
+	fclose(fp);
+
+	return 1;
+}
+
+// Prints the metrics of every column side by side, naming those of each
+// device as the command line does
+static void printTable(FILE * fp, const int * succeeded){
+	double values[MAX_LOCKSTEP_CONFIGS + 1]
+		     [numTableMetrics + NUM_DEVICE_METRICS * MAX_DEVICES];
+	int rows = numTableMetrics + NUM_DEVICE_METRICS * params.numDevices;
+	int columns = params.numLockstepConfigs + 1;
+	char label[BUFF_SZ];
+	int c, i;
+
+	for (c = 0; c < columns; c++)
+		if (succeeded[c] && !readColumn(metricsPaths[c], values[c]))
+			perrorExit("lockstep.c - failed to read metrics");
+
+	fprintf(fp, "%-24s %16s", "metric", "base");
+	for (c = 1; c < columns; c++)
+		fprintf(fp, " %16.16s", params.lockstepConfigs[c - 1]);
+	fprintf(fp, "\n");
+
+	for (i = 0; i < rows; i++){
+		if (i < numTableMetrics)
+			snprintf(label, sizeof(label), "%s", tableMetrics[i]);
+		else
+			snprintf(label, sizeof(label), "%s%s",
+				 params.devices[(i - numTableMetrics)
+						/ NUM_DEVICE_METRICS].name,
+				 deviceMetrics[(i - numTableMetrics)
+					       % NUM_DEVICE_METRICS]);
+		fprintf(fp, "%-24s", label);
+		for (c = 0; c < columns; c++){
+			if (succeeded[c])
+				fprintf(fp, " %16.9g", values[c][i]);
+			else
+				fprintf(fp, " %16s", "failed");
+		}
+		fprintf(fp, "\n");
+	}
+}
+
+// Draws the workload and forks a child for each configuration, returning
+// only in the children. oss prints the table and exits once they all have.
+void forkLockstepRuns(){
+	char tmpDir[] = "/tmp/osslockstep.XXXXXX";
+	int columns = params.numLockstepConfigs + 1;
+	int succeeded[MAX_LOCKSTEP_CONFIGS + 1];
+	pid_t pids[MAX_LOCKSTEP_CONFIGS + 1];
+	int c, status, failed = 0;
+
+	generateWorkload();
+
+	// Writes the metrics of each column where -m says, or to a temporary
+	// directory that is removed at the end
+	if (params.metricsPath == NULL && mkdtemp(tmpDir) == NULL)
+		perrorExit("lockstep.c - failed to create metrics directory");
+	for (c = 0; c < columns; c++){
+		if (params.metricsPath != NULL)
+			columnPath(metricsPaths[c], params.metricsPath, c);
+		else
+			snprintf(metricsPaths[c], PATH_MAX, "%s/%d", tmpDir, c);
+	}
+
+	fflush(stdout);
+	for (c = 0; c < columns; c++){
+		if ((pids[c] = fork()) == -1)
+			perrorExit("lockstep.c - failed to fork");
+		if (pids[c] == 0){
+			beginColumn(c);
+			return;
+		}
+	}
+
+	for (c = 0; c < columns; c++){
+		if (waitpid(pids[c], &status, 0) == -1)
+			perrorExit("lockstep.c - failed to wait for a run");
+		succeeded[c] = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		if (!succeeded[c]){
+			fprintf(stderr, "%s: run of column %d failed\n",
+				exeName, c);
+			failed = 1;
+		}
+	}
+
+	printTable(stdout, succeeded);
+
+	if (params.metricsPath == NULL){
+		for (c = 0; c < columns; c++)
+			unlink(metricsPaths[c]);
+		rmdir(tmpDir);
+	}
+
+	exit(failed);
+}
+
+// Returns the lifetime of the next arrival, setting its class and the gap to
+// the one after it
+int lockstepArrival(SchedulingClass * schedulingClass, Clock * gap){
+	if (nextArrival == MAX_TOTAL_GENERATED)
+		perrorExit("lockstep.c - workload has no more arrivals");
+
+	*schedulingClass = processes[nextArrival].schedulingClass;
+	*gap = processes[nextArrival].gap;
+
+	return nextArrival++;
+}
+
+// Starts the bursts of simPid at the first of the given lifetime
+void beginLockstepProcess(int simPid, int lifetime){
+	nextBurst[simPid] = processes[lifetime].firstBurst;
+}
+
+// Replaces a dispatch message with the reply of the process's next burst,
+// its time scaled to the quantum of the message
+void replayBurst(int simPid, char * msgText){
+	unsigned long long quantum = strtoul(msgText, NULL, 10);
+
+	memcpy(msgText, bursts[nextBurst[simPid]++], MSG_SZ);
+	setBurstTime(msgText, strtoul(msgText + 2, NULL, 10) * quantum
+			      / LOCKSTEP_QUANTUM);
+}
@@ -0,0 +1,18 @@
+// lockstep.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions that compare scheduler
+// configurations given with -W on one workload, simulating each in a child
+// of its own and printing their metrics side by side.
+
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include "clock.h"
+#include "pcb.h"
+
+void forkLockstepRuns();
+int lockstepArrival(SchedulingClass * schedulingClass, Clock * gap);
+void beginLockstepProcess(int simPid, int lifetime);
+void replayBurst(int simPid, char * msgText);
+
+#endif
@@ -0,0 +1,102 @@
+// logcat.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains osslog, a program which writes the log of an oss run to
+// standard output. The log may be one file or the segments left by -g or -G,
+// which are read in order, and each file is decompressed if it was written
+// with -z.
+
+#include <glob.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compress.h"
+#include "constants.h"
+#include "perrorExit.h"
+
+static void printFile(const char * path);
+
+int main(int argc, char * argv[]){
+	char pattern[BUFF_SZ];
+	const char * path = argc > 1 ? argv[1] : LOG_FILE_NAME;
+	FILE * fp;
+	glob_t segments;
+	size_t i;
+
+	exeName = argv[0];
+
+	if (argc > 2){
+		fprintf(stderr, "Usage: %s [log path]\n", exeName);
+		exit(1);
+	}
+
+	// Prints an unsegmented log
+	if ((fp = fopen(path, "r")) != NULL){
+		fclose(fp);
+		printFile(path);
+		return 0;
+	}
+
+	// Prints the segments that are left, oldest first
+	snprintf(pattern, sizeof(pattern), "%s.[0-9][0-9][0-9][0-9][0-9][0-9]",
+		 path);
+	if (glob(pattern, 0, NULL, &segments) != 0){
+		fprintf(stderr, "%s: no log or log segments at %s\n", exeName,
+			path);
+		exit(1);
+	}
+
+	for (i = 0; i < segments.gl_pathc; i++)
+		printFile(segments.gl_pathv[i]);
+
+	globfree(&segments);
+
+	return 0;
+}
+
+// Copies a log file to standard output, decompressing its blocks if needed
+static void printFile(const char * path){
+	static char raw[LOG_BUFFER_SIZE];
+	static char packed[COMPRESS_BOUND(LOG_BUFFER_SIZE)];
+	char magic[LOG_MAGIC_SIZE];
+	int header[2], stored, size;
+	size_t bytes;
+	FILE * fp;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		perrorExit("Failed to open log file");
+
+	// Copies a file without the magic number as it is
+	bytes = fread(magic, 1, LOG_MAGIC_SIZE, fp);
+	if (bytes < LOG_MAGIC_SIZE || memcmp(magic, LOG_MAGIC, LOG_MAGIC_SIZE)){
+		fwrite(magic, 1, bytes, stdout);
+		while ((bytes = fread(raw, 1, sizeof(raw), fp)) > 0)
+			fwrite(raw, 1, bytes, stdout);
+		fclose(fp);
+		return;
+	}
+
+	while (fread(header, sizeof(header), 1, fp) == 1){
+		stored = header[1] & LOG_BLOCK_STORED;
+		size = header[1] & ~LOG_BLOCK_STORED;
+
+		if (header[0] < 0 || header[0] > LOG_BUFFER_SIZE || size < 0
+		    || size > sizeof(packed)
+		    || fread(packed, 1, size, fp) != size){
+			fprintf(stderr, "%s: %s is truncated\n", exeName, path);
+			break;
+		}
+
+		if (stored){
+			fwrite(packed, 1, size, stdout);
+		} else if (decompressBlock(packed, size, raw, sizeof(raw))
+			   == header[0]){
+			fwrite(raw, 1, header[0], stdout);
+		} else {
+			fprintf(stderr, "%s: %s is corrupt\n", exeName, path);
+			break;
+		}
+	}
+
+	fclose(fp);
+}
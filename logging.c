@@ -2,109 +2,551 @@
 //
 // This file contains definitions for functions that aid in the collection,
 // formatting, and logging of data pertinent to Assignment 4.
+//
+// Lines are gathered in a page-aligned buffer of LOG_BUFFER_SIZE bytes that is
+// written with one pwrite at an offset that is a multiple of its size. A
+// partly filled buffer written by flushLog is written again, from the same
+// offset, once it fills. With -g or -G the log is a series of segments,
+// <log>.000001, <log>.000002 and so on, each started when the last reaches a
+// size or an age in real seconds, and -k removes all but the newest segments.
+// With -z every buffer is compressed (compress.c) and written as a block
+// after an 8 byte header of its raw and stored sizes; osslog reads the log
+// back whatever its form.
+//
+// Each log function makes a LogRecord of what happened, and writeRecord
+// formats its line and trace events. With -M the records pass through a
+// StageQueue to an output thread that does the formatting, compressing and
+// writing, so the dispatcher only copies a few words per line. The records
+// carry every value their lines show, so the log is the same either way.
 
 #include "clock.h"
+#include "compress.h"
 #include "constants.h"
+#include "logging.h"
+#include "parameters.h"
 #include "perrorExit.h"
+#include "profile.h"
+#include "quantum.h"
+#include "stageQueue.h"
+#include "trace.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int log = -1;		// Descriptor of the current segment
+static char * buffer = NULL;	// Lines not yet written in full
+static char * packed = NULL;	// Compressed buffer, with -z
+static int used = 0;		// Bytes in buffer
+static long blockOffset = 0;	// Offset buffer is written at
+static long segmentSize = 0;	// Bytes written to the current segment
+static int segment = 0;		// Number of the segment, 0 if unsegmented
+static time_t segmentStart;	// Real time the segment was started
+
+static int burstSimPid;		// Process of the last burst received
+static Clock burstEnd;		// Time the last burst received ended
 
-static FILE * log = NULL;
-static int lines = 0;
+typedef enum LogType {
+	LOG_GENERATION, LOG_DISPATCH, LOG_DISPATCH_TIME, LOG_RECEIPT,
+	LOG_PARTIAL_QUANTUM, LOG_ENQUEUE, LOG_BLOCKING, LOG_PREEMPTION,
+	LOG_WAKE_UP, LOG_PROMOTION, LOG_QUANTA, LOG_QUANTUM,
+	LOG_DEVICE_REQUEST, LOG_DEVICE_SERVICE,
+	LOG_FLUSH,		// Writes the buffer out
+	LOG_STOP		// Ends the output thread
+} LogType;
 
-// Opens the log file if closed, prints the line, and increments lines
-static void printLine(char * line){
-	if (++lines > MAX_LOG_LINES) return;
+// Something to log, with the values its line shows
+typedef struct logRecord {
+	LogType type;
+	int simPid;		// Process, or scheduling class for LOG_QUANTUM
+	int queueNum;		// Queue, level for LOG_QUANTUM or device
+	unsigned int value;	// Burst length, dispatch time or quantum
+	Clock time;
+} LogRecord;
 
-	// Opens the log file if it is not already open
-	if (log == NULL)
-		if ((log = fopen(LOG_FILE_NAME, "w+")) == NULL)
-			perrorExit("logging.c - failed to open log file");
+static StageQueue records;	// Records sent to the output thread
+static pthread_t outputThread;
+static int outputThreadRunning = 0;
 
-	fprintf(log, "%s", line); 
-	//fflush(log);
+static void emit(LogType type, int simPid, int queueNum, unsigned int value,
+		 Clock time);
+static void stopOutputThread();
+
+// Returns nonzero if the log is split into segments
+static int segmented(){
+	return params.logSegmentBytes > 0 || params.logSegmentSeconds > 0;
 }
 
-// Logs the generation and enqueueing of a new process
-void logGeneration(int simPid, int queueNum, Clock time){
+// Writes the path of segment number n, or the log path if unsegmented
+static void segmentPath(int n, char * path, int size){
+	if (n == 0)
+		snprintf(path, size, "%s", params.logPath);
+	else
+		snprintf(path, size, LOG_SEGMENT_FORMAT, params.logPath, n);
+}
+
+// Writes all of size bytes at offset, exiting on failure
+static void writeAt(const char * bytes, int size, long offset){
+	if (pwrite(log, bytes, size, offset) != size)
+		perrorExit("logging.c - failed to write log file");
+}
+
+// Opens segment number n, creating it empty or keeping the first keep bytes.
+// A log such as /dev/null that can't be truncated is used as it is.
+static void openSegment(int n, long keep){
+	char path[BUFF_SZ];
+
+	segmentPath(n, path, sizeof(path));
+	if ((log = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) == -1
+	    || (ftruncate(log, keep) == -1 && errno != EINVAL))
+		perrorExit("logging.c - failed to open log file");
+
+	segment = n;
+	segmentSize = keep;
+	segmentStart = time(NULL);
+	used = 0;
+
+	// Starts a compressed segment with its magic number
+	if (params.logCompressed && keep == 0){
+		writeAt(LOG_MAGIC, LOG_MAGIC_SIZE, 0);
+		segmentSize = LOG_MAGIC_SIZE;
+	}
+	blockOffset = segmentSize;
+
+	// Keeps only the newest segments if asked
+	if (n > params.logSegmentsKept && params.logSegmentsKept > 0){
+		segmentPath(n - params.logSegmentsKept, path, sizeof(path));
+		if (unlink(path) == -1 && errno != ENOENT)
+			perrorExit("logging.c - failed to remove log segment");
+	}
+}
+
+// Allocates the buffer, and the compressed buffer with -z, if not yet done
+static void allocateBuffers(){
+	if (buffer != NULL) return;
+
+	if (posix_memalign((void **) &buffer, LOG_BUFFER_ALIGN,
+			   LOG_BUFFER_SIZE) != 0
+	    || (params.logCompressed && (packed = malloc(2 * sizeof(int)
+		+ COMPRESS_BOUND(LOG_BUFFER_SIZE))) == NULL))
+		perrorExit("logging.c - failed to allocate log buffer");
+}
+
+// Allocates the buffers and opens the first segment
+static void openLog(){
+	allocateBuffers();
+	openSegment(segmented() ? 1 : 0, 0);
+}
+
+// Returns the bytes the buffer holds before it is written, fewer than its size
+// if an uncompressed segment ends sooner
+static int bufferCapacity(){
+	long left = params.logSegmentBytes - blockOffset;
+
+	if (params.logCompressed || params.logSegmentBytes == 0
+	    || left >= LOG_BUFFER_SIZE)
+		return LOG_BUFFER_SIZE;
+
+	return left > 0 ? left : 1;
+}
+
+// Writes the buffer, keeping a partial uncompressed one to be written again
+static void writeBuffer(){
+	int header[2], size;
+
+	if (used == 0) return;
+
+	if (!params.logCompressed){
+		writeAt(buffer, used, blockOffset);
+		segmentSize = blockOffset + used;
+		if (used < bufferCapacity()) return;
+
+		blockOffset += used;
+		used = 0;
+		return;
+	}
+
+	// Stores the block as it is if compressing didn't make it smaller
+	size = compressBlock(buffer, used, packed + sizeof(header));
+	header[0] = used;
+	header[1] = size;
+	if (size >= used){
+		memcpy(packed + sizeof(header), buffer, used);
+		header[1] = used | LOG_BLOCK_STORED;
+		size = used;
+	}
+	memcpy(packed, header, sizeof(header));
+
+	writeAt(packed, sizeof(header) + size, blockOffset);
+	blockOffset += sizeof(header) + size;
+	segmentSize = blockOffset;
+	used = 0;
+}
+
+// Ends the current segment and starts the next
+static void rotate(){
+	writeBuffer();
+	close(log);
+	openSegment(segment + 1, 0);
+}
+
+// Adds a line to the log, writing the buffer when it fills
+static void printLine(const char * line){
+	int length = strlen(line), part;
+	PROFILE_SCOPE(STAGE_LOG);
+
+	if (log == -1) openLog();
+
+	// Starts a segment once the current one is old enough
+	if (params.logSegmentSeconds > 0
+	    && time(NULL) - segmentStart >= params.logSegmentSeconds)
+		rotate();
+
+	while (length > 0){
+		part = bufferCapacity() - used;
+		if (part > length) part = length;
+
+		memcpy(buffer + used, line, part);
+		used += part;
+		line += part;
+		length -= part;
+
+		if (used < bufferCapacity()) break;
+
+		// Starts a segment once the current one is big enough
+		writeBuffer();
+		if (params.logSegmentBytes > 0
+		    && segmentSize >= params.logSegmentBytes)
+			rotate();
+	}
+}
+
+// Writes buffered lines to the log file, once the output thread reaches them
+void flushLog(){
+	emit(LOG_FLUSH, 0, 0, 0, zeroClock());
+}
+
+// Writes buffered lines and closes the log file
+void closeLog(){
+	stopOutputThread();
+	if (log == -1) return;
+
+	writeBuffer();
+	close(log);
+	log = -1;
+}
+
+// Gets the segment and offset at the end of the log, for checkpoints
+void saveLogPosition(LogPosition * position){
+	flushLog();
+	position->segment = log == -1 ? -1 : segment;
+	position->offset = log == -1 ? 0 : segmentSize;
+}
+
+// Reopens the log, discarding anything written after a saved position
+void restoreLogPosition(const LogPosition * position){
+	char path[BUFF_SZ];
+	int n;
+
+	closeLog();
+
+	// Removes segments written after the checkpoint
+	if (segmented()){
+		for (n = position->segment == -1 ? 1 : position->segment + 1;
+		     ; n++){
+			segmentPath(n, path, sizeof(path));
+			if (unlink(path) == -1) break;
+		}
+	}
+
+	// Starts the log afresh if nothing had been written
+	if (position->segment == -1){
+		openLog();
+		return;
+	}
+
+	allocateBuffers();
+	openSegment(position->segment, position->offset);
+
+	// Reads back the partial buffer of an uncompressed log
+	if (!params.logCompressed){
+		blockOffset = position->offset
+			      - position->offset % LOG_BUFFER_SIZE;
+		used = position->offset - blockOffset;
+		if (pread(log, buffer, used, blockOffset) != used)
+			perrorExit("logging.c - failed to rewind log file");
+	}
+}
+
+// Writes the line of a record, and its trace events, to the log
+static void writeRecord(const LogRecord * r){
+	static char quanta[BUFF_SZ + NUM_CLASSES * MAX_QUEUE_LEVELS * 12];
+	static int quantaLength;
 	char buff[BUFF_SZ];
-	lines++;	// Exta new line character
 
-	// Prints message
-	sprintf(buff, "\nOSS: Generating process with PID %d and putting it in" \
-		" queue %d at time %03u : %09u\n", simPid, queueNum, 
-		time.seconds, time.nanoseconds); 
-	printLine(buff);
+	switch (r->type){
+	case LOG_GENERATION:
+		sprintf(buff, "\nOSS: Generating process with PID %d and putting"
+			" it in queue %d at time %03u : %09u\n", r->simPid,
+			r->queueNum, r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+
+		traceInstant(r->simPid, "generated", r->time);
+		traceState(r->simPid, "ready", r->time);
+		traceDepth(r->queueNum, 1, r->time);
+		break;
+
+	case LOG_DISPATCH:
+		sprintf(buff, "\nOSS: Dispatching process with PID %d from queue"
+			" %d at time %03u : %09u\n", r->simPid, r->queueNum,
+			r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+
+		traceState(r->simPid, "running", r->time);
+		traceDepth(r->queueNum, -1, r->time);
+		break;
+
+	case LOG_DISPATCH_TIME:
+		sprintf(buff, "OSS: total time this dispatch was %u"
+			" nanoseconds\n", r->value);
+		printLine(buff);
+		break;
+
+	case LOG_RECEIPT:
+		sprintf(buff, "OSS: Receiving that process with PID %d ran for"
+			" %u nanoseconds\n", r->simPid, r->value);
+		printLine(buff);
+
+		// Remembers the end of the burst for the line logged next
+		burstSimPid = r->simPid;
+		burstEnd = clockSum(r->time, newClock(0, r->value));
+		break;
+
+	case LOG_PARTIAL_QUANTUM:
+		printLine("OSS: not using its entire time quantum\n");
+
+		traceState(burstSimPid, NULL, burstEnd);
+		traceInstant(burstSimPid, "terminated", burstEnd);
+		break;
+
+	case LOG_ENQUEUE:
+		sprintf(buff, "OSS: Putting process with PID %d into queue %d\n",
+			r->simPid, r->queueNum);
+		printLine(buff);
+
+		traceState(r->simPid, "ready", burstEnd);
+		traceDepth(r->queueNum, 1, burstEnd);
+		break;
+
+	case LOG_BLOCKING:
+		sprintf(buff, "OSS: Process with PID %d is BLOCKED, waiting for"
+			" I/O until time %d : %d\n", r->simPid,
+			r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+
+		traceState(r->simPid, "blocked", burstEnd);
+		traceDepth(-1, 1, burstEnd);
+		break;
+
+	case LOG_DEVICE_REQUEST:
+		snprintf(buff, sizeof(buff), "OSS: Process with PID %d is"
+			 " BLOCKED, waiting for device %s from time %03u :"
+			 " %09u\n", r->simPid, params.devices[r->queueNum].name,
+			 r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+
+		traceState(r->simPid, "blocked", burstEnd);
+		traceDepth(-1, 1, burstEnd);
+		break;
+
+	case LOG_DEVICE_SERVICE:
+		snprintf(buff, sizeof(buff), "OSS: Device %s serving process"
+			 " with PID %d until time %03u : %09u\n",
+			 params.devices[r->queueNum].name, r->simPid,
+			 r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+		break;
+
+	case LOG_PREEMPTION:
+		sprintf(buff, "OSS: Process with PID %d is PREEMPTED, added to the"
+			" head of queue %d at time %03u : %09u\n", r->simPid,
+			r->queueNum, r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+
+		traceState(r->simPid, "preempted", burstEnd);
+		traceDepth(r->queueNum, 1, burstEnd);
+		break;
+
+	case LOG_WAKE_UP:
+		sprintf(buff, "\nOSS: Process with PID %d has been moved from the"
+			" blocked queue to queue %d at %03u : %09u\n",
+			r->simPid, r->queueNum, r->time.seconds,
+			r->time.nanoseconds);
+		printLine(buff);
+
+		traceState(r->simPid, "ready", r->time);
+		traceDepth(-1, -1, r->time);
+		traceDepth(r->queueNum, 1, r->time);
+		break;
+
+	case LOG_PROMOTION:
+		sprintf(buff, "OSS: Process with PID %d has aged and been promoted"
+			" to queue %d at %03u : %09u\n", r->simPid, r->queueNum,
+			r->time.seconds, r->time.nanoseconds);
+		printLine(buff);
+
+		traceDepth(r->queueNum + 1, -1, r->time);
+		traceDepth(r->queueNum, 1, r->time);
+		break;
+
+	// Starts the line of quanta, which a record per quantum completes
+	case LOG_QUANTA:
+		quantaLength = sprintf(quanta, "OSS: Quanta at time %03u : %09u"
+				       " are", r->time.seconds,
+				       r->time.nanoseconds);
+		break;
+
+	// Adds the quantum of class simPid and level queueNum to the line
+	case LOG_QUANTUM:
+		if (r->queueNum == 0)
+			quantaLength += sprintf(quanta + quantaLength,
+						r->simPid == NORMAL
+						? " normal" : ", real time");
+		quantaLength += sprintf(quanta + quantaLength, " %u", r->value);
+
+		if (r->simPid == NUM_CLASSES - 1
+		    && r->queueNum == params.numQueueLevels - 1){
+			sprintf(quanta + quantaLength, "\n");
+			printLine(quanta);
+		}
+		break;
+
+	case LOG_FLUSH:
+		if (log != -1) writeBuffer();
+		break;
+
+	case LOG_STOP:
+		break;
+	}
+}
+
+// Formats and writes the records the dispatcher sends until told to stop
+static void * runOutputThread(void * unused){
+	LogRecord record;
+
+	do {
+		stagePop(&records, &record);
+		writeRecord(&record);
+	} while (record.type != LOG_STOP);
+
+	return NULL;
+}
+
+// Passes a record to the output thread, or writes it at once without one
+static void emit(LogType type, int simPid, int queueNum, unsigned int value,
+		 Clock time){
+	LogRecord record = {type, simPid, queueNum, value, time};
+
+	if (outputThreadRunning)
+		stagePush(&records, &record);
+	else
+		writeRecord(&record);
+}
+
+// Moves formatting and writing the log and trace to a thread of their own
+void startOutputThread(){
+	createStageQueue(&records, OUTPUT_QUEUE_CAPACITY, sizeof(LogRecord));
+	startStageThread(&outputThread, runOutputThread);
+	outputThreadRunning = 1;
+}
+
+// Writes out the records already sent and ends the output thread, if any
+static void stopOutputThread(){
+	if (!outputThreadRunning) return;
+
+	// Leaves a thread stopped by an error where it is, writing from here on
+	if (threadFailed(outputThread)){
+		outputThreadRunning = 0;
+		return;
+	}
+
+	emit(LOG_STOP, 0, 0, 0, zeroClock());
+	pthread_join(outputThread, NULL);
+	destroyStageQueue(&records);
+	outputThreadRunning = 0;
+}
+
+// Logs the generation and enqueueing of a new process
+void logGeneration(int simPid, int queueNum, Clock time){
+	emit(LOG_GENERATION, simPid, queueNum, 0, time);
 }
 
 // Logs the dispatching of a process 
 void logDispatch(int simPid, int queueNum, Clock time){
-	char buff[BUFF_SZ];
-	lines++;	// Extra new line character
-
-	// Prints message
-	sprintf(buff, "\nOSS: Dispatching process with PID %d from queue %d at" \
-		" time %03u : %09u\n", simPid, queueNum, time.seconds,
-		time.nanoseconds);
-	printLine(buff);
+	emit(LOG_DISPATCH, simPid, queueNum, 0, time);
 }
 
 // Logs the simulated processor time taken to dispatch a process 
 void logDispatchTime(unsigned int time){
-	char buff[BUFF_SZ];
-	sprintf(buff, "OSS: total time this dispatch was %u nanoseconds\n", time); 
-	printLine(buff);
+	emit(LOG_DISPATCH_TIME, 0, 0, time, zeroClock());
 }
 
-// Logs messages recieved from user processes
-void logMessageReciept(int simPid, unsigned int burstLength){
-	char buff[BUFF_SZ];
-	sprintf(buff, "OSS: Receiving that process with PID %d ran for %u" \
-	       " nanoseconds\n", simPid, burstLength);
-	printLine(buff);
+// Logs messages recieved from user processes, for a burst begun at time
+void logMessageReciept(int simPid, unsigned int burstLength, Clock time){
+	emit(LOG_RECEIPT, simPid, 0, burstLength, time);
 }
 
 // Logs that the process that sent the message didn't use its entire timeslice
 void logPartialQuantumUse(){
-	char buff[BUFF_SZ];
-	sprintf(buff, "OSS: not using its entire time quantum\n");
-	printLine(buff);
+	emit(LOG_PARTIAL_QUANTUM, 0, 0, 0, zeroClock());
 }
 
-
 // Logs the enqueueing of a process control block
 void logEnqueue(int simPid, int queueNum){
-	char buff[BUFF_SZ];
-	sprintf(buff, "OSS: Putting process with PID %d into queue %d\n", 
-		simPid, queueNum);
-	printLine(buff);
+	emit(LOG_ENQUEUE, simPid, queueNum, 0, zeroClock());
 }
 
 // Logs that a process is blocked until an I/O event at a particular time
 void logBlocking(int simPid, Clock nextIoEventTime){
-	char buff[BUFF_SZ];
-	sprintf(buff, "OSS: Process with PID %d is BLOCKED, waiting for I/O"
-		" until time %d : %d\n", simPid, nextIoEventTime.seconds, 
-		nextIoEventTime.nanoseconds);
-	printLine(buff);
+	emit(LOG_BLOCKING, simPid, 0, 0, nextIoEventTime);
+}
+
+// Logs that a process is blocked waiting for a device from a particular time
+void logDeviceRequest(int simPid, int device, Clock time){
+	emit(LOG_DEVICE_REQUEST, simPid, device, 0, time);
+}
+
+// Logs that a device has begun serving a process until a particular time
+void logDeviceService(int simPid, int device, Clock until){
+	emit(LOG_DEVICE_SERVICE, simPid, device, 0, until);
 }
 
 // Logs that a process has been preempted at a given time
 void logPreemption(int simPid, int queueNum, Clock currentTime){
-	char buff[BUFF_SZ];
-	sprintf(buff, "OSS: Process with PID %d is PREEMPTED, added to the"
-		" head of queue %d at time %03u : %09u\n", simPid, queueNum,
-		currentTime.seconds, currentTime.nanoseconds);
-	printLine(buff);
+	emit(LOG_PREEMPTION, simPid, queueNum, 0, currentTime);
 }
 
 // Logs that a process has been moved from the blocked queue to a ready queue
 void logWakeUp(int simPid, int queueNum, Clock time){
-	char buff[BUFF_SZ];
-	lines++; 	// Accounts for extra new line character
-	
-	sprintf(buff, "\nOSS: Process with PID %d has been moved from the"
-		" blocked queue to queue %d at %03u : %09u\n", simPid,
-		queueNum, time.seconds, time.nanoseconds);
-	printLine(buff);
+	emit(LOG_WAKE_UP, simPid, queueNum, 0, time);
+}
+
+// Logs that an aged process has been moved up to a higher priority queue
+void logPromotion(int simPid, int queueNum, Clock time){
+	emit(LOG_PROMOTION, simPid, queueNum, 0, time);
+}
+
+// Logs the quantum of each level for each scheduling class
+void logQuanta(Clock time){
+	int class, level;
 
+	emit(LOG_QUANTA, 0, 0, 0, time);
+	for (class = 0; class < NUM_CLASSES; class++)
+		for (level = 0; level < params.numQueueLevels; level++)
+			emit(LOG_QUANTUM, class, level,
+			     levelQuantum(class, level), time);
 }
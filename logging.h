@@ -8,6 +8,23 @@
 
 #include "clock.h"
 
+// Where the log ended, saved in checkpoints
+typedef struct logPosition {
+	int segment;		// Segment being written, or -1 if none
+	long offset;		// Bytes in that segment
+} LogPosition;
+
+// Formats and writes the log on a thread of its own
+void startOutputThread();
+
+// Writes buffered lines to the log file, and closes it
+void flushLog();
+void closeLog();
+
+// Saves and restores the position in the log, for checkpoints
+void saveLogPosition(LogPosition * position);
+void restoreLogPosition(const LogPosition * position);
+
 // Logs the generation and enqueueing of a new process
 void logGeneration(int simPid, int queueNum, Clock time);
 
@@ -18,7 +35,7 @@ void logDispatch(int simPid, int queueNum, Clock time);
 void logDispatchTime(unsigned int time);
 
 // Logs messages recieved from user processes
-void logMessageReciept(int simPid, unsigned int burstLength);
+void logMessageReciept(int simPid, unsigned int burstLength, Clock time);
 
 // Logs that the process that sent the message didn't use its entire timeslice
 void logPartialQuantumUse();
@@ -28,8 +45,17 @@ void logEnqueue(int simPid, int queueNum);
 
 void logBlocking(int simPid, Clock nextIoEventTime);
 
+// Logs a process blocking on a device, and the device starting to serve it
+void logDeviceRequest(int simPid, int device, Clock time);
+void logDeviceService(int simPid, int device, Clock until);
+
 void logPreemption(int simPid, int queueNum, Clock currentTime);
 
 void logWakeUp(int simPid, int queueNum, Clock time);
 
+void logPromotion(int simPid, int queueNum, Clock time);
+
+// Logs the quantum of each level when they are adapted
+void logQuanta(Clock time);
+
 #endif
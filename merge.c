@@ -0,0 +1,165 @@
+// merge.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains ossmerge, a program which merges the sketch files that
+// oss writes with -d and prints the quantiles of every sketch. The sketches of
+// a metric, class and level in each file are merged into one, so a fleet of
+// runs is summarized exactly as if its processes had all been in one run.
+// With -o the merged sketches are also written as a sketch file, which can be
+// merged again.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "perrorExit.h"
+#include "sketch.h"
+
+#define MAX_MERGED 256		// Different sketches merged
+#define NAME_SZ 40		// Size of metric and class names, read as %39s
+
+typedef struct mergedSketch {
+	char name[BUFF_SZ];	// Metric, class and level
+	Sketch sketch;
+} MergedSketch;
+
+static void mergeFile(const char * path);
+static Sketch * findSketch(const char * name);
+static void printQuantiles();
+static void writeMerged(const char * path);
+
+static MergedSketch merged[MAX_MERGED];	// In the order first read
+static int numMerged = 0;
+
+int main(int argc, char * argv[]){
+	const char * outPath = NULL;	// Sketch file written, if any
+	int opt;
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "o:h")) != -1){
+		if (opt == 'o'){
+			outPath = optarg;
+		} else {
+			fprintf(stderr, "Usage: %s [-o path] sketch file...\n",
+				exeName);
+			exit(1);
+		}
+	}
+
+	if (optind == argc){
+		fprintf(stderr, "%s: no sketch files given\n", exeName);
+		exit(1);
+	}
+
+	for (; optind < argc; optind++)
+		mergeFile(argv[optind]);
+
+	printQuantiles();
+	if (outPath != NULL)
+		writeMerged(outPath);
+
+	return 0;
+}
+
+// Merges every sketch in a file into the sketch of the same name
+static void mergeFile(const char * path){
+	char metric[NAME_SZ], class[NAME_SZ], name[BUFF_SZ];
+	char * line = NULL;
+	size_t size = 0;
+	Sketch sketch;
+	int level, length;
+	FILE * fp;
+
+	if ((fp = fopen(path, "r")) == NULL)
+		perrorExit("merge.c - failed to open sketch file");
+
+	// Refuses files of other formats, whose buckets may differ
+	if (getline(&line, &size, fp) == -1
+	    || strncmp(line, SKETCH_FORMAT, strlen(SKETCH_FORMAT)) != 0){
+		fprintf(stderr, "%s: %s is not a sketch file\n", exeName,
+			path);
+		exit(1);
+	}
+
+	while (getline(&line, &size, fp) != -1){
+		if (sscanf(line, "%39s %39s %d%n", metric, class, &level,
+			   &length) != 3
+		    || !readSketch(line + length, &sketch)){
+			fprintf(stderr, "%s: bad sketch in %s\n", exeName,
+				path);
+			exit(1);
+		}
+
+		snprintf(name, sizeof(name), "%s %s %d", metric, class,
+			 level);
+		sketchMerge(findSketch(name), &sketch);
+	}
+
+	free(line);
+	fclose(fp);
+}
+
+// Returns the merged sketch of a name, adding an empty one if there is none
+static Sketch * findSketch(const char * name){
+	int i;
+
+	for (i = 0; i < numMerged; i++)
+		if (strcmp(merged[i].name, name) == 0)
+			return &merged[i].sketch;
+
+	if (numMerged == MAX_MERGED){
+		fprintf(stderr, "%s: more than %d different sketches\n",
+			exeName, MAX_MERGED);
+		exit(1);
+	}
+
+	snprintf(merged[numMerged].name, BUFF_SZ, "%s", name);
+	memset(&merged[numMerged].sketch, 0, sizeof(Sketch));
+
+	return &merged[numMerged++].sketch;
+}
+
+// Prints the count and quantiles in seconds of every merged sketch
+static void printQuantiles(){
+	static const double quantiles[] = {0.5, 0.9, 0.99};
+	char metric[NAME_SZ], class[NAME_SZ];
+	const Sketch * sketch;
+	unsigned long long ns;
+	int i, j, level;
+
+	printf("%-10s %-9s %5s %10s %14s %14s %14s\n", "metric", "class",
+	       "level", "count", "p50", "p90", "p99");
+
+	for (i = 0; i < numMerged; i++){
+		sketch = &merged[i].sketch;
+		sscanf(merged[i].name, "%39s %39s %d", metric, class,
+		       &level);
+
+		printf("%-10s %-9s %5d %10lu", metric, class, level,
+		       sketch->count);
+		for (j = 0; j < 3; j++){
+			ns = sketchQuantile(sketch, quantiles[j]);
+			printf(" %14.9Lf", (long double) ns / BILLION);
+		}
+		printf("\n");
+	}
+}
+
+// Writes the merged sketches as a sketch file
+static void writeMerged(const char * path){
+	FILE * fp;
+	int i;
+
+	if ((fp = fopen(path, "w")) == NULL)
+		perrorExit("merge.c - failed to open merged sketch file");
+
+	fprintf(fp, "%s\n", SKETCH_FORMAT);
+	for (i = 0; i < numMerged; i++){
+		fprintf(fp, "%s", merged[i].name);
+		writeSketch(fp, &merged[i].sketch);
+	}
+
+	fclose(fp);
+}
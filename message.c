@@ -2,7 +2,11 @@
 //
 // This file contains implementations of utility functions which aid in the
 // use of a message queue to send and recieve messages.
+//
+// Message text is copied whole rather than as a string, since a reply holds
+// several fields, each ending in '\0'.
 
+#include <errno.h>
 #include <sys/msg.h>
 #include <sys/stat.h>
 #include <string.h>
@@ -27,7 +31,7 @@ void sendMessage(int msgQueueId, const char * msgText, long int type){
 
 	// Initializes message
 	msg.type = type;
-	strcpy(msg.str, msgText);
+	memcpy(msg.str, msgText, MSG_SZ);
 	
 	// Sends message
 	if ((msgsnd(msgQueueId, (const void *)&msg, sizeof(msg.str), 0)) == -1)
@@ -44,7 +48,40 @@ void waitForMessage(int msgQueueId, char * msgText, long int type){
 			perrorExit("Error waiting for message");
 
 	// Copies message text
-	strcpy(msgText, msg.str);
+	memcpy(msgText, msg.str, MSG_SZ);
+}
+
+// Copies a message of the selected type if one is queued, returning nonzero
+int receiveMessageNoWait(int msgQueueId, char * msgText, long int type){
+	Message msg;	// Buffer for message to be received
+
+	if ((msgrcv(msgQueueId, (void *)&msg, sizeof(msg.str), type,
+		    IPC_NOWAIT)) == -1){
+		if (errno == ENOMSG) return 0;
+		perrorExit("Error receiving message");
+	}
+
+	// Copies message text
+	memcpy(msgText, msg.str, MSG_SZ);
+
+	return 1;
+}
+
+// Sends a batch to the host of user processes
+void sendHostMessage(int msgQueueId, HostMessage * msg){
+	msg->type = HOST_MSG_TYPE;
+
+	if (msgsnd(msgQueueId, (const void *) msg,
+		   sizeof(HostMessage) - sizeof(long int), 0) == -1)
+		perrorExit("Couldn't send message to host");
+}
+
+// Blocks until a batch for the host of user processes is recieved
+void waitForHostMessage(int msgQueueId, HostMessage * msg){
+	if (msgrcv(msgQueueId, (void *) msg,
+		   sizeof(HostMessage) - sizeof(long int), HOST_MSG_TYPE, 0)
+	    == -1)
+		perrorExit("Error waiting for message");
 }
 
 // Removes the message queue with the specified id
@@ -1,11 +1,13 @@
 // message.h was created by Mark Renard on 3/27/2020.
 //
 // This file contains the definition of a struct used to pass messages between
-// oss and user processes and headers for message queue utility functions.
+// oss and user processes, of the batch oss sends a host of coroutines in
+// their place, and headers for message queue utility functions.
 
 #ifndef MESSAGE_H
 #define MESSAGE_H
 
+#include "clock.h"
 #include "constants.h"
 
 typedef struct message {
@@ -13,9 +15,28 @@ typedef struct message {
 	char str[MSG_SZ];
 } Message;
 
+// A process for a host to start, with its lifetime
+typedef struct hostSpawn {
+	int simPid;
+	unsigned int generation;
+} HostSpawn;
+
+// The processes generated since the last dispatch, then the dispatch itself
+typedef struct hostMessage {
+	long int type;			// Always HOST_MSG_TYPE
+	Clock time;			// Time of the dispatch
+	int numSpawns;
+	HostSpawn spawns[MAX_BLOCKS];
+	int simPid;			// Process dispatched
+	char quantum[MSG_SZ];		// Its dispatch message
+} HostMessage;
+
 int getMessageQueue(int key, int flags);
 void sendMessage(int msgQueueId, const char * msgText, long int type);
 void waitForMessage(int msgQueueId, char * msgText, long int type);
+int receiveMessageNoWait(int msgQueueId, char * msgText, long int type);
+void sendHostMessage(int msgQueueId, HostMessage * msg);
+void waitForHostMessage(int msgQueueId, HostMessage * msg);
 void removeMessageQueue(int msgQueueId);
 
 #endif
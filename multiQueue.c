@@ -3,18 +3,18 @@
 // These functions facillitate the enqueueing and dequeueing of simulated 
 // process control blocks in a multi-level feedback queue.
 
+#include "device.h"
 #include "multiQueue.h"
+#include "parameters.h"
 #include "queue.h"
 #include "pcb.h"
 #include "perrorExit.h"
 #include "logging.h"
+#include "profile.h"
+#include "statistics.h"
 
 #include <unistd.h>
 
-// Used for determining whether a process priority should be promoted due to age
-const Clock WAIT_TIME_THRESHOLD = {PROMOTION_WAIT_TIME_THRESHOLD_SEC,
-				   PROMOTION_WAIT_TIME_THRESHOLD_NS};
-
 // Used to increment simulated system clock while waking up blocked processes
 const Clock WAKE_UP_INCREMENT = {WAKE_UP_INCREMENT_SEC,
 				 WAKE_UP_INCREMENT_NS};
@@ -22,11 +22,12 @@ const Clock WAKE_UP_INCREMENT = {WAKE_UP_INCREMENT_SEC,
 // Initializes values in a MultiQueue, including those of constituent queues
 void initializeMultiQueue(MultiQueue * multiQ){
 	int i;
-	for (i = 0; i < NUM_QUEUE_LEVELS; i++){
+	for (i = 0; i < params.numQueueLevels; i++){
 		initializeQueue(&multiQ->readyQueues[i]);
 	}
 
 	initializeQueue(&multiQ->blockedQueue);
+	initializeQueue(&multiQ->wakingQueue);
 
 	multiQ->count = 0;
 	multiQ->readyCount = 0;
@@ -38,7 +39,7 @@ void printMultiQueue(FILE * fp, MultiQueue * mQueue){
 	int i;
 
 	// Prints ready queues
-	for (i = 0; i < NUM_QUEUE_LEVELS; i++){
+	for (i = 0; i < params.numQueueLevels; i++){
 		fprintf(fp, "(%02d)Queue %d: ", 
 			mQueue->readyQueues[i].count, i);
 
@@ -61,58 +62,83 @@ void mAddToBlockedQueue(Queue * blockedQueue, ProcessControlBlock * pcb){
 
 	// Adds to front if interupt time is earliest
 	} else if (clockCompare(pcb->nextIoEventTime,
-				blockedQueue->front->nextIoEventTime) < 0){
+				queueFront(blockedQueue)->nextIoEventTime) < 0){
 		addToFront(blockedQueue, pcb);
 
 	// Adds to position that maintains sorting by time of next I/O event
 	} else {
-		ProcessControlBlock * previous = blockedQueue->front->previous;
-		ProcessControlBlock * next = blockedQueue->front;	
+		int position = 1;
 
-		// Traverses queue while previous has same or earlier I/O event
-		while (previous != NULL \
-		       && clockCompare(previous->nextIoEventTime,
+		// Walks queue while blocks have same or earlier I/O event
+		while (position < blockedQueue->count \
+		       && clockCompare(queueAt(blockedQueue,
+					       position)->nextIoEventTime,
 				       pcb->nextIoEventTime) <= 0){
-			next = previous;
-			previous = previous->previous;
+			position++;
 		}
 
 		// Inserts pcb into blocked queue
-		pcb->previous = previous;
-		next->previous = pcb;
-		blockedQueue->count++;
+		insertInQueue(blockedQueue, position, pcb);
 	}
 		
 }
 
+// Moves a blocked pcb to its ready queue, adding simulated time to now
+static void wakeUp(MultiQueue * multiQ, ProcessControlBlock * pcb, Clock * now){
+
+	// Wakes up and adds to appropriate queue
+	pcb->state = READY;
+	enqueue(&multiQ->readyQueues[pcb->priority], pcb);
+
+	// Updates counts
+	multiQ->blockedCount--;
+	multiQ->readyCount++;
+
+	// Adds simulated time
+	incrementClock(now, WAKE_UP_INCREMENT);
+
+	// Logs wake-up
+	logWakeUp(pcb->simPid, pcb->priority, *now);
+	statWakeUp(pcb->simPid, *now);
+}
+
 // Re-enqueues blocked processes if I/O happened, returns simulated overhead
 void checkBlockedProcesses(MultiQueue * multiQ, Clock * now){
 	struct processControlBlock * pcb; 
-	
-	// Traverses blocked queue until the end or I/O event is in the future
-	while((pcb = multiQ->blockedQueue.front) != NULL
-	      && clockCompare(pcb->nextIoEventTime, *now) <= 0){
-		
-	
-		// Wakes up and adds to appropriate queue
-		pcb = dequeue(&multiQ->blockedQueue);
-		pcb->state = READY;
-		enqueue(&multiQ->readyQueues[pcb->priority], pcb);
+	PROFILE_SCOPE(STAGE_WAKE);
 
-		// Updates counts
-		multiQ->blockedCount--;
-		multiQ->readyCount++;
+	// Wakes processes staged by mStageWakeUps, which come first
+	while (multiQ->wakingQueue.count > 0)
+		wakeUp(multiQ, dequeue(&multiQ->wakingQueue), now);
+	
+	// Traverses blocked queue until the end or I/O event is in the future,
+	// letting devices start the services due by now before each check
+	while (1){
+		advanceDevices(multiQ, *now);
+		if ((pcb = queueFront(&multiQ->blockedQueue)) == NULL
+		    || clockCompare(pcb->nextIoEventTime, *now) > 0)
+			break;
+		wakeUp(multiQ, dequeue(&multiQ->blockedQueue), now);
+	}
+}
 
-		// Adds simulated time
-		incrementClock(now, WAKE_UP_INCREMENT);
+// Moves blocked processes whose I/O happened by now to the waking queue
+//
+// The clock only advances, so they are certain to be woken by the next call
+// to checkBlockedProcesses, ahead of any process blocked after now.
+void mStageWakeUps(MultiQueue * multiQ, Clock now){
+	struct processControlBlock * pcb; 
 
-		// Logs wake-up
-		logWakeUp(pcb->simPid, pcb->priority, *now);
+	advanceDevices(multiQ, now);
+	while((pcb = queueFront(&multiQ->blockedQueue)) != NULL
+	      && clockCompare(pcb->nextIoEventTime, now) <= 0){
+		enqueue(&multiQ->wakingQueue, dequeue(&multiQ->blockedQueue));
 	}
 }
 
 // Adds pcb to a blocked or ready queue, changing its priority if applicable
 void mEnqueue(MultiQueue * multiQ, ProcessControlBlock * pcb){
+	PROFILE_SCOPE(STAGE_ENQUEUE);
 #ifdef DEBUG_Q
 	fprintf(stderr, "\nCount: %d\n", multiQ->count);
 	printMultiQueue(stderr, multiQ);
@@ -128,7 +154,7 @@ void mEnqueue(MultiQueue * multiQ, ProcessControlBlock * pcb){
 		return;
 
 	// Otherwise, lowers priority if not minimum and not real time or new
-	} else if (pcb->priority < NUM_QUEUE_LEVELS - 1
+	} else if (pcb->priority < params.numQueueLevels - 1
 		   && pcb->schedulingClass != REAL_TIME
 		   && pcb->state != NEW){
 		pcb->priority++;
@@ -151,8 +177,8 @@ static void promoteSufficientlyAgedProcesses(MultiQueue * multiQ, Clock now){
 	double cpuUtilization;
 
 	int i;
-	for (i = 2; i < NUM_QUEUE_LEVELS; i++){
-		pcb = multiQ->readyQueues[i].front; // Selects next queue head
+	for (i = 2; i < params.numQueueLevels; i++){
+		pcb = queueFront(&multiQ->readyQueues[i]); // Next queue head
 
 		// Skips empty queues
 		if (pcb == NULL) continue;
@@ -165,7 +191,8 @@ static void promoteSufficientlyAgedProcesses(MultiQueue * multiQ, Clock now){
 
 		// Determines whether to promote process
 		if (cpuUtilization < UTIL_THRESHOLD \
-		    &&(clockCompare(processWaitTime, WAIT_TIME_THRESHOLD) >=0)){
+		    &&(clockCompare(processWaitTime,
+				    params.promotionWaitThreshold) >= 0)){
 		
 			// Increases process priority
 			pcb->priority--;
@@ -173,6 +200,7 @@ static void promoteSufficientlyAgedProcesses(MultiQueue * multiQ, Clock now){
 			// Moves process control block to the next queue
 			dequeue(&multiQ->readyQueues[i]);
 			enqueue(&multiQ->readyQueues[i - 1], pcb);
+			logPromotion(pcb->simPid, i - 1, now);
 		}				
 
 	}
@@ -180,19 +208,20 @@ static void promoteSufficientlyAgedProcesses(MultiQueue * multiQ, Clock now){
 
 // Promotes aged processes and returns the PCB of the next process to schedule
 ProcessControlBlock * mDequeue(MultiQueue * multiQ, Clock currentTime){
-	// promoteSufficientlyAgedProcesses(multiQ, currentTime);
+	if (params.agingEnabled)
+		promoteSufficientlyAgedProcesses(multiQ, currentTime);
 #ifdef DEBUG_Q
 	fprintf(stderr, "\nCount: %d\n", multiQ->count);
 	printMultiQueue(stderr, multiQ);
 #endif
 	// Finds the index of the highest priority non-empty queue
 	int i;
-	for (i = 0; i < NUM_QUEUE_LEVELS; i++){
+	for (i = 0; i < params.numQueueLevels; i++){
 		if (multiQ->readyQueues[i].count > 0) break;
 	}
 
 	// Error if all ready queues are empty
-	if (i == NUM_QUEUE_LEVELS) 
+	if (i == params.numQueueLevels) 
 		perrorExit("Called mDequeue with no process in ready queue");
 
 #ifdef DEBUG_Q
@@ -12,18 +12,21 @@
 #include "pcb.h"
 
 typedef struct multiQueue {
-	Queue readyQueues[NUM_QUEUE_LEVELS];
+	Queue readyQueues[MAX_QUEUE_LEVELS];
 	Queue blockedQueue;
+	Queue wakingQueue;	// Blocked pcbs certain to wake next, in order
 
 	int count;		// Total count of pcbs in all queues
 	int readyCount;		// Number of pcbs in ready queues
-	int blockedCount;	// Number of pcbs in blocked queue
+	int blockedCount;	// Number of pcbs in blocked and waking queues
 
 } MultiQueue;
 
 void initializeMultiQueue(MultiQueue * multiQ);
 void checkBlockedProcesses(MultiQueue * multiQ, Clock * now);
+void mStageWakeUps(MultiQueue * multiQ, Clock now);
 void mEnqueue(MultiQueue * multiQ, ProcessControlBlock * pcb);
+void mAddToBlockedQueue(Queue * blockedQueue, ProcessControlBlock * pcb);
 ProcessControlBlock * mDequeue(MultiQueue * multiQ, Clock currentTime);
 void mAddPreempted(MultiQueue *, ProcessControlBlock *);
 
@@ -3,7 +3,10 @@
 // This file contains a program which simulates the scheduling of an operating
 // system using a multi-level feedback queue.
 
+#include <errno.h>
 #include <mqueue.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,39 +16,98 @@
 #include <unistd.h>
 
 #include "bitVector.h"
+#include "burst.h"
+#include "checkpoint.h"
 #include "constants.h"
 #include "clock.h"
+#include "completionRing.h"
+#include "device.h"
+#include "eventLoop.h"
+#include "history.h"
+#include "lockstep.h"
 #include "logging.h"
 #include "message.h"
 #include "multiQueue.h"
+#include "parameters.h"
 #include "pcb.h"
 #include "perrorExit.h"
+#include "placement.h"
+#include "profile.h"
+#include "quantum.h"
+#include "realExecution.h"
 #include "queue.h"
 #include "randomGen.h"
 #include "sharedMemory.h"
+#include "stageQueue.h"
+#include "statistics.h"
+#include "trace.h"
 #include "getSharedMemoryPointers.h"
 
 
+	/* Types */
+
+// A process about to be generated, prepared before its time in pipelined mode
+typedef struct arrival {
+	int simPid;			// Reserved simPid of the process
+	unsigned int generation;	// Lifetime the simPid is starting
+	SchedulingClass schedulingClass;
+	Clock gap;			// Time from this arrival to the next
+	int lifetime;			// Its process in the -W workload
+} Arrival;
+
+// A child for the spawn thread to fork, with -M
+typedef struct spawnRequest {
+	int simPid;			// simPid of the child, or -1 to stop
+	unsigned int generation;	// Lifetime the child is for
+} SpawnRequest;
+
+
 	/* Prototypes */
 
-static void launchUserProcesses(Clock *, ProcessControlBlock *);
-static void generateProcess(Clock, ProcessControlBlock *, MultiQueue *);
-static void launchProcess(int);
-static ProcessControlBlock * dispatchProcess(Clock *, MultiQueue *);
+static void launchUserProcesses(SharedClock *, ProcessControlBlock *);
+static void prepareArrival(Arrival *);
+static void generateProcess(const Arrival *, Clock, ProcessControlBlock *,
+			    MultiQueue *);
+static void stageAhead(Clock, const ProcessControlBlock *, MultiQueue *, long,
+		       Clock, Clock *);
+static void stageQuantumMessages();
+static int moreToGenerate(long);
+static void checkWindows(Clock);
+static void claimInstance();
+static void requestLaunch(int, unsigned int);
+static void * runSpawnThread(void *);
+static void stopSpawnThread();
+static void launchProcess(int, unsigned int);
+static void launchHost();
+static pid_t forkChild(int);
+static void waitForSpawn(const ProcessControlBlock *);
+static ProcessControlBlock * dispatchProcess(Clock *, MultiQueue *, char *);
+static void simulateInProcess(ProcessControlBlock *, char *);
+static void waitForReply(ProcessControlBlock *, char *, Clock);
+static void waitForRingReply(const ProcessControlBlock *, char *, Clock);
+static int collectRingReplies(int);
+static void pollEvents(Clock);
+static void handleEvent(const Event *, Clock);
+static void reapChild(pid_t);
+static void runControlCommands(Clock);
 static unsigned int processMessage(const char *, ProcessControlBlock *, 
 				   MultiQueue *, Clock);
-void parseMessage(char *, unsigned int *, int *, int *, const char*);
+void parseMessage(char *, unsigned int *, int *, int *, int *, const char*);
+static void readRestoredSettings();
+static void restoreRun(Clock *, ProcessControlBlock *, MultiQueue *, long *,
+		       Clock *);
+static void takeCheckpoint(Clock, ProcessControlBlock *, MultiQueue *, long,
+			   Clock);
 static void assignSignalHandlers();
-static void cleanUpAndExit(int param);
+static void recordSignal(int param);
+static void exitOnSignal();
 static void cleanUp();
 
 
 	/* Constants (computed from values in constants.h) */
 
-// Min and max time between generating processes (0 and 2 seconds by default)
+// Min time between generating processes, the max being set by -e
 const static Clock minTimeBetweenNewProcs = {0, 0};
-const static Clock maxTimeBetweenNewProcs = {maxTimeBetweenNewProcsSecs,
-					     maxTimeBetweenNewProcsNS};
 
 // Min and max system clock increment at each loop (default 1 and 1.000001 secs)
 const static Clock MIN_LOOP_INCREMENT = {LOOP_INCREMENT_SECONDS,
@@ -61,167 +123,615 @@ const static Clock MAX_SCHEDULING_TIME = {0, MAX_SCHEDULING_TIME_NS};
 	/* Static Global Variables */
 
 static char * shm = NULL; // Pointer to the shared memory region
-static int dispatchMqId;  // ID of message queue for process dispatching
-static int interruptMqId; // ID of message queue for recieiving interrupt info
+static StatsPage * stats; // Stats page in shared memory, read by osstop
+static CompletionRing * ring; // Replies from user processes, with -T ring
+static int dispatchMqId = -1;  // ID of message queue for process dispatching
+static int interruptMqId = -1; // ID of message queue for recieiving interrupt info
+static RandomGenerator ossGenerator; // Generator used by oss itself
+static Checkpoint checkpoint;	     // Last checkpoint written or read
+static pid_t childPids[MAX_BLOCKS];  // Real pids of children, 0 if none
+static int stopGenerating = 0;	     // Set by the stop control command
+static Clock windowEnd;		     // End of the warm-up or current window
+static int windowNumber = 0;	     // Current window, 0 during warm-up
+static int measurementDone = 0;	     // Set when the last window ends
+// Dispatch message of each scheduling class and queue level
+static char quantumMessages[NUM_CLASSES][MAX_QUEUE_LEVELS][MSG_SZ];
+static Arrival stagedArrival;	     // Next arrival, if prepared early
+static int arrivalStaged = 0;	     // Nonzero if stagedArrival is set
+static StageQueue spawnRequests;     // Children to fork, with -M
+static pthread_t spawnThread;	     // Thread forking children, with -M
+static int spawnThreadRunning = 0;   // Nonzero once spawnThread is started
+static unsigned int spawned[MAX_BLOCKS]; // Generation forked for each simPid
+static pid_t hostPid = 0;	     // Real pid of the host, with -U
+static HostMessage hostBatch;	     // Spawns for the host's next message
+static unsigned long workloadLoops = 0; // Spin loops per us, with -X
+static volatile sig_atomic_t stopSignal = 0; // Signal received, if any
+static char ringReplies[MAX_BLOCKS][MSG_SZ]; // Not yet processed, with -T ring
+static int ringReceived[MAX_BLOCKS];	     // Nonzero if ringReplies[i] is set
 
 int main(int argc, char * argv[]){
 	ProcessControlBlock * processTable;	// Shared memory process table
-	Clock * systemClock;			// Shared memory system clock
+	SharedClock * systemClock;		// Shared memory system clock
 
 	alarm(MAX_SECONDS);	// Limits total execution time
 	exeName = argv[0];	// Assigns exeName for perrorExit
+	parseParameters(argc, argv); // Overrides defaults from constants.h
+
+	// Simulates each configuration compared with -W in a child of its own,
+	// printing the comparison here once they finish
+	if (params.numLockstepConfigs > 0)
+		forkLockstepRuns();
+
+	PROFILE_INIT();		// Calibrates timers when built with PROFILE
 	assignSignalHandlers();	// Sets response to ctrl + C & alarm
+	errorCleanUp = cleanUp;	// Cleans up before perrorExit exits
 	initializeBitVector();	// Sets bit vector values to 0
 
-	srand(BASE_SEED - 1);	// Seeds pseudorandom number generator
+	// Uses the settings of the checkpointed run when resuming one
+	if (params.restorePath != NULL)
+		readRestoredSettings();
+
+	// Pins oss and picks the cpus of its children
+	applyPlacement();
+
+	// Seeds pseudorandom number generator
+	useRandomGenerator(&ossGenerator);
+	seedRandom(params.seed - 1);
+
+	// Creates the checkpoint file, after any restore has read it
+	if (params.checkpointPath != NULL)
+		openCheckpointFile(params.checkpointPath);
+
+	// Reserves the instance so no other oss uses its IPC objects
+	claimInstance();
+
+	// Creates the doorbell, timer and control FIFO oss waits on
+	char controlPath[BUFF_SZ];
+	sprintf(controlPath, CONTROL_FIFO_FORMAT, params.instance);
+	openEventLoop(controlPath);
 
 	// Creates message queues
-	dispatchMqId = getMessageQueue(DISPATCH_MQ_KEY, MQ_PERMS | IPC_CREAT);
-	interruptMqId = getMessageQueue(REPLY_MQ_KEY, MQ_PERMS | IPC_CREAT);
+	dispatchMqId = getMessageQueue(instanceKey(DISPATCH_MQ_KEY),
+				       MQ_PERMS | IPC_CREAT);
+	interruptMqId = getMessageQueue(instanceKey(REPLY_MQ_KEY),
+					MQ_PERMS | IPC_CREAT);
 
 	// Creates shared memory region and gets pointers
 	getSharedMemoryPointers(&shm, &systemClock, &processTable, IPC_CREAT);
+	stats = getStatsPage(shm);
+	statInitPage(stats);
+	ring = getCompletionRing(shm);
+	initializeCompletionRing(ring);
+
+	// Starts the trace of the run if asked
+	if (params.tracePath != NULL)
+		openTrace(params.tracePath);
+
+	// Keeps the burst history of each process if asked
+	if (params.historyPath != NULL)
+		openHistory(params.historyPath);
+
+	// Starts the I/O devices processes block on if any were given
+	if (params.numDevices > 0)
+		openDevices();
+
+	// Calibrates the workloads of processes that run for real if asked
+	if (params.realExecution)
+		workloadLoops = openRealExecution();
+
+	// Starts the process hosting every user process if asked
+	if (params.hosted)
+		launchHost();
+
+	// Forks children and writes the log on threads of their own if asked
+	if (params.threaded){
+		startOutputThread();
+		if (!params.inProcess && !params.hosted){
+			createStageQueue(&spawnRequests, SPAWN_QUEUE_CAPACITY,
+					 sizeof(SpawnRequest));
+			startStageThread(&spawnThread, runSpawnThread);
+			spawnThreadRunning = 1;
+		}
+	}
 
 	// Generates, enqueues, and dispatches user processes in a loop
 	launchUserProcesses(systemClock, processTable);
 
+	// Writes run metrics and the cpus they were measured on if requested
+	if (params.metricsPath != NULL){
+		writeMetrics(params.metricsPath, readSharedClock(systemClock));
+		writePlacement(params.metricsPath);
+	}
+
+	// Writes the sketches of each class and level if requested
+	if (params.sketchPath != NULL)
+		writeSketches(params.sketchPath);
+
+	// Prints where oss spent its time when built with PROFILE
+	PROFILE_REPORT(stderr);
+
 	cleanUp();
 
 	return 0;
 }
 
 // Schedules and launches user processes
-static void launchUserProcesses(Clock * systemClock,
+static void launchUserProcesses(SharedClock * sharedClock,
 				ProcessControlBlock * processTable) {
 	char msgText[MSG_SZ];	   // Message text from last dispatched process
 	unsigned int nano;	   // Nanoseconds used by last process & enqueue
 	ProcessControlBlock * pcb; // PCB of last dispatched process
+	Arrival arrival;	   // Process being generated
 	
-	int totalGenerated = 0;	   // Total processes generated
+	long totalGenerated = 0;   // Total processes generated
 	Clock timeToGenerate;	   // Random time to generate the next process
-	MultiQueue q;		   // MultiQueue of process control blocks
+	Clock nextCheckpoint;	   // Time of the next checkpoint, if any
+	MultiQueue * q;		   // MultiQueue of pcbs, in shared memory
+
+	Clock localClock;	   // Clock of oss, published to sharedClock
+	Clock * systemClock = &localClock;
+	Clock loopIncrement;	   // Drawn during the burst when pipelined
+	int incrementDrawn;	   // Nonzero if loopIncrement was drawn
+
+	q = getMultiQueue(shm);
+
+	// Continues from a checkpoint or starts a new run
+	if (params.restorePath != NULL){
+		restoreRun(systemClock, processTable, q, &totalGenerated,
+			   &timeToGenerate);
+	} else {
+		initializeMultiQueue(q);
+		initializeQuanta();
+
+		// Initializes system clock
+		*systemClock = zeroClock();
+
+		// Sets random time in the future to launch a process
+		timeToGenerate = randomTime(minTimeBetweenNewProcs, 
+					    params.maxArrivalGap);
+	}
 
-	initializeMultiQueue(&q);
+	initializeSharedClock(sharedClock, *systemClock);
+	nextCheckpoint = clockSum(*systemClock, params.checkpointInterval);
 
-	// Initializes system clock
-	*systemClock = zeroClock();
+	// Times the warm-up of a streaming run, which may be empty
+	if (params.streaming){
+		windowEnd = params.warmUp;
+		checkWindows(*systemClock);
+	}
 
-	// Sets random time in the future to launch a process
-	timeToGenerate = randomTime(minTimeBetweenNewProcs, 
-				    maxTimeBetweenNewProcs);
+	// Stages the dispatch messages, logging the first quanta of a new run
+	stageQuantumMessages();
+	if (params.quantumPercentile > 0 && params.restorePath == NULL)
+		logQuanta(*systemClock);
 
 	// Generates and schedules user processes in a loop
 	do {
+		PROFILE_SCOPE(STAGE_LOOP);
+		incrementDrawn = 0;
+
 		// Generates process if time reached and within process limits
 		if (clockCompare(*systemClock, timeToGenerate) >= 0
-		    && q.count < MAX_BLOCKS
-		    && totalGenerated < MAX_TOTAL_GENERATED){
+		    && q->count < MAX_BLOCKS
+		    && moreToGenerate(totalGenerated)){
+			PROFILE_BEGIN(STAGE_GENERATE);
+
+			// Uses the arrival prepared during the last burst, if any
+			if (arrivalStaged)
+				arrival = stagedArrival;
+			else
+				prepareArrival(&arrival);
+			arrivalStaged = 0;
 
 			// Generates new process, updates counter
-			generateProcess(*systemClock, processTable, &q);	
+			generateProcess(&arrival, *systemClock, processTable, q);
 			totalGenerated++;
 
 			// Sets new random time to launch a new process
-			incrementClock(&timeToGenerate, 
-				       randomTime(minTimeBetweenNewProcs,
-						  maxTimeBetweenNewProcs));
+			incrementClock(&timeToGenerate, arrival.gap);
+			PROFILE_END(STAGE_GENERATE);
 		}
 
 		// Checks and wakes up blocked processes, increments systemClock
-		if (q.blockedCount > 0) 
-			checkBlockedProcesses(&q, systemClock);
+		if (q->blockedCount > 0) 
+			checkBlockedProcesses(q, systemClock);
 
 		// Schedules/dispatches a process from queue, if non-empty
-		if (q.readyCount > 0){
+		if (q->readyCount > 0){
 
-			pcb = dispatchProcess(systemClock, &q);
+			statRoundTripBegin();
+			pcb = dispatchProcess(systemClock, q, msgText);
 
 			// Adds simulated time taken by scheduling
 			incrementClock(systemClock, 
 				       randomTime(MIN_SCHEDULING_TIME,
 						  MAX_SCHEDULING_TIME));
-			
 
-			// Waits for message from dispatched process
-			waitForMessage(interruptMqId, msgText, pcb->simPid + 1);
+			// Does work that can't depend on the reply while waiting
+			if (params.pipelined){
+				stageAhead(*systemClock, pcb, q, totalGenerated,
+					   timeToGenerate, &loopIncrement);
+				incrementDrawn = 1;
+			}
+			
+			// Runs the burst or waits for the dispatched process
+			publishClock(sharedClock, *systemClock);
+			PROFILE_BEGIN(STAGE_BURST);
+			if (params.inProcess)
+				simulateInProcess(pcb, msgText);
+			else
+				waitForReply(pcb, msgText, *systemClock);
+			PROFILE_END(STAGE_BURST);
+			statRoundTripEnd();
 		
 			// Records time & re-queues process or logs termination
-			nano = processMessage(msgText, pcb, &q, *systemClock);
+			nano = processMessage(msgText, pcb, q, *systemClock);
 
 			// Adds execution time and enqueueing overhead to clock
 			incrementClock(systemClock, newClock(0, nano));
 		}
 
 		// Increments system clock
-		Clock rand = randomTime(MIN_LOOP_INCREMENT,
-				        MAX_LOOP_INCREMENT);
-		incrementClock(systemClock, rand);
+		if (!incrementDrawn)
+			loopIncrement = randomTime(MIN_LOOP_INCREMENT,
+						   MAX_LOOP_INCREMENT);
+		incrementClock(systemClock, loopIncrement);
+
+		// Publishes the clock to user processes
+		publishClock(sharedClock, *systemClock);
+
+		// Publishes counters and queue depths for osstop
+		statPublish(stats, q, *systemClock);
+
+		// Handles exits, timer expiries and commands already pending
+		pollEvents(*systemClock);
+		exitOnSignal();
+
+		// Ends the warm-up or measurement window once its time comes
+		if (params.streaming)
+			checkWindows(*systemClock);
+
+		// Saves the state of the run once each checkpoint interval
+		if (params.checkpointPath != NULL
+		    && clockCompare(*systemClock, nextCheckpoint) >= 0){
+			takeCheckpoint(*systemClock, processTable, q,
+				       totalGenerated, timeToGenerate);
+			nextCheckpoint = clockSum(*systemClock,
+						  params.checkpointInterval);
+		}
 
 	// Continues until max user processes generated and queue is empty
-	} while ( (totalGenerated < MAX_TOTAL_GENERATED || q.count > 0) );
+	} while ((moreToGenerate(totalGenerated) || q->count > 0)
+		 && !measurementDone);
+
+	statFinish(stats);
 }
 
-// Creates a process control block and launches a corresponding process
-static void generateProcess(Clock time, ProcessControlBlock * processTable, 
-			    MultiQueue * queue){
-	int newPid;		// The simulated pid of the new process
-	SchedulingClass class;	// The scheduling class of the new process
+// Reserves a simPid, draws the class and next gap, and launches a child
+//
+// The draws are made in the order the serial loop always made them, and the
+// child waits for its block to become RUNNING, so this can run a burst early.
+static void prepareArrival(Arrival * arrival){
 
 	// Gets an available simulated pid from the int vector
-	newPid = getIntFromBitVector();
-	if (newPid == -1)
+	arrival->simPid = getIntFromBitVector();
+	if (arrival->simPid == -1)
 		perrorExit("generateProcess called with no available PCBs");
+	arrival->generation = pcbFromSimPid(arrival->simPid)->generation + 1;
+
+	// Determines scheduling class and time until the next arrival, taking
+	// them from the shared workload with -W
+	if (params.numLockstepConfigs > 0){
+		arrival->lifetime = lockstepArrival(&arrival->schedulingClass,
+						    &arrival->gap);
+	} else {
+		arrival->schedulingClass =
+			randBinary(params.realTimeProbability)
+			? REAL_TIME : NORMAL;
+		arrival->gap = randomTime(minTimeBetweenNewProcs,
+					  params.maxArrivalGap);
+	}
 
-	// Determines scheduling class
-	class = randBinary(REAL_TIME_PROBABILITY) ? REAL_TIME : NORMAL;
+#ifdef DEBUG
+	fprintf(stderr, "About to launch process %d\n", arrival->simPid);
+	sleep(1);
+#endif
+	// Forks and execs a child unless simulating processes in-process
+	if (!params.inProcess)
+		requestLaunch(arrival->simPid, arrival->generation);
+}
+
+// Creates the process control block of a prepared arrival and enqueues it
+static void generateProcess(const Arrival * arrival, Clock time,
+			    ProcessControlBlock * processTable,
+			    MultiQueue * queue){
+	int newPid = arrival->simPid;	   // The simulated pid of the new process
+	SchedulingClass class = arrival->schedulingClass;
  
 	// Initializes the process control block for the new process
-	processTable[newPid] = initialProcessControlBlock(newPid, time, class);
+	processTable[newPid] = initialProcessControlBlock(newPid,
+							  arrival->generation,
+							  class);
+	*pcbAccounting(&processTable[newPid]) = initialProcessAccounting(time);
 
 	// Adds the new process control block to the queue
 	mEnqueue(queue, &processTable[newPid]);
 
 	// Logs process generation
 	logGeneration(newPid, processTable[newPid].priority, time);
+	statGeneration(newPid, time);
+	beginHistory(newPid);
 
-#ifdef DEBUG
-	fprintf(stderr, "About to launch process %d\n", newPid);
-	sleep(1);
-#endif
-	// Forks and execs new child process
-	launchProcess(newPid);	
+	// Seeds the process's own generator when simulated in-process
+	if (params.inProcess)
+		seedRandomGenerator(&pcbAccounting(&processTable[newPid])->generator,
+				    params.seed + newPid + time.nanoseconds);
+	if (params.numLockstepConfigs > 0)
+		beginLockstepProcess(newPid, arrival->lifetime);
 
 	// Changes process state to ready in new process control block
 	processTable[newPid].state = READY;
 
 }
 
-// Forks and execs a new child process
-static void launchProcess(int simPid){
-	int realPid;
+// Does the part of the next iteration that can't depend on the running burst
+//
+// The loop increment is the next draw the serial loop makes, so it is drawn
+// now. If the next arrival is certain to be due at the top of the next
+// iteration, whatever the reply says, it is prepared, forking its child while
+// the burst runs: the clock only advances, the queue has room even if the
+// running process is re-queued, and the simPid chosen is the same whether or
+// not the running process terminates and frees its own. Blocked processes
+// whose I/O has already happened are staged for waking.
+static void stageAhead(Clock now, const ProcessControlBlock * running,
+		       MultiQueue * q, long totalGenerated,
+		       Clock timeToGenerate, Clock * loopIncrement){
+	int nextSimPid = peekIntFromBitVector(-1);
+
+	*loopIncrement = randomTime(MIN_LOOP_INCREMENT, MAX_LOOP_INCREMENT);
+
+	if (clockCompare(now, timeToGenerate) >= 0
+	    && q->count + 1 < MAX_BLOCKS
+	    && moreToGenerate(totalGenerated)
+	    && nextSimPid != -1
+	    && nextSimPid == peekIntFromBitVector(running->simPid)){
+		prepareArrival(&stagedArrival);
+		arrivalStaged = 1;
+	}
 
-	// Forks or exits on failure using perror
-	if ((realPid = fork()) == -1){
-		perrorExit("Failed to fork");
+	mStageWakeUps(q, now);
+}
+
+// Returns nonzero while processes are still to be generated
+static int moreToGenerate(long totalGenerated){
+	return !stopGenerating
+	       && (params.streaming || totalGenerated < MAX_TOTAL_GENERATED);
+}
+
+// Begins the measurement after the warm-up and prints each window that ends
+//
+// A streaming run ends with the last window rather than draining its queues,
+// so its metrics describe only the steady state.
+static void checkWindows(Clock now){
+	if (clockCompare(now, windowEnd) < 0) return;
+
+	if (windowNumber == 0)
+		statBeginMeasurement(now);
+	else
+		statWindow(stdout, windowNumber, now);
+
+	if (params.numWindows > 0 && windowNumber == params.numWindows){
+		measurementDone = 1;
+		return;
+	}
+
+	windowNumber++;
+	incrementClock(&windowEnd, params.windowLength);
+}
+
+// Builds the dispatch message of each queue level and scheduling class
+static void stageQuantumMessages(){
+	int class, level;
+
+	for (class = 0; class < NUM_CLASSES; class++)
+		for (level = 0; level < params.numQueueLevels; level++)
+			sprintf(quantumMessages[class][level], "%u",
+				levelQuantum(class, level));
+}
+
+// Creates the dispatch queue of the instance exclusively, picking one if asked
+static void claimInstance(){
+	int automatic = params.instance == AUTO_INSTANCE;
+	int tries = 0;
+
+	// Starts the search for a free instance at one derived from the pid
+	if (automatic)
+		params.instance = getpid() % MAX_INSTANCES;
+
+	while (msgget(instanceKey(DISPATCH_MQ_KEY),
+		      MQ_PERMS | IPC_CREAT | IPC_EXCL) == -1){
+		if (errno != EEXIST)
+			perrorExit("Failed to create message queue");
+
+		// Exits if the instance was given or none is free
+		if (!automatic || ++tries == MAX_INSTANCES){
+			fprintf(stderr, "%s: instance %d is in use or has stale"
+				" IPC objects (see ipcs)\n", exeName,
+				params.instance);
+			exit(1);
+		}
+
+		params.instance = (params.instance + 1) % MAX_INSTANCES;
+	}
+
+	// Tells the user which instance to watch with osstop
+	if (automatic)
+		fprintf(stderr, "%s: instance %d\n", exeName, params.instance);
+}
+
+// Launches a child, has the spawn thread launch it with -M, or has the host
+// start it with the next dispatch with -U
+static void requestLaunch(int simPid, unsigned int generation){
+	SpawnRequest request = {simPid, generation};
+
+	if (params.hosted){
+		if (hostBatch.numSpawns == MAX_BLOCKS)
+			perrorExit("Too many processes for the host's batch");
+		hostBatch.spawns[hostBatch.numSpawns++] =
+			(HostSpawn) {simPid, generation};
+	} else if (spawnThreadRunning)
+		stagePush(&spawnRequests, &request);
+	else
+		launchProcess(simPid, generation);
+}
+
+// Forks the children requested by the dispatcher until told to stop
+//
+// The dispatcher may send a child its first quantum before it is forked, since
+// the dispatch message waits in its queue, so forking costs the dispatcher
+// nothing unless the process terminates before this thread records its pid.
+static void * runSpawnThread(void * unused){
+	SpawnRequest request;
+
+	for (stagePop(&spawnRequests, &request); request.simPid != -1;
+	     stagePop(&spawnRequests, &request)){
+		launchProcess(request.simPid, request.generation);
+		__atomic_store_n(&spawned[request.simPid], request.generation,
+				 __ATOMIC_RELEASE);
 	}
 
+	return NULL;
+}
+
+// Forks any children still requested and ends the spawn thread, if any
+static void stopSpawnThread(){
+	SpawnRequest stop = {-1, 0};
+
+	if (!spawnThreadRunning) return;
+	spawnThreadRunning = 0;
+
+	// Leaves a thread stopped by an error where it is
+	if (threadFailed(spawnThread)) return;
+
+	stagePush(&spawnRequests, &stop);
+	pthread_join(spawnThread, NULL);
+	destroyStageQueue(&spawnRequests);
+}
+
+// Forks and execs a new child process
+static void launchProcess(int simPid, unsigned int generation){
+	static int launched = 0; // Children launched so far, for placement
+	int realPid;
+
 	// Child execs the user process
-	if (realPid == 0){
+	if ((realPid = forkChild(launched)) == 0){
 
-		// Converts simPid to string
+		// Converts simPid, seed, instance, region and doorbell fds
 		char sPid[BUFF_SZ];
+		char sGeneration[BUFF_SZ];
+		char sSeed[BUFF_SZ];
+		char sInstance[BUFF_SZ];
+		char sShmFd[BUFF_SZ];
+		char sDoorbell[BUFF_SZ];
+		char sTransport[BUFF_SZ];
+		char sInterrupt[BUFF_SZ];
+		char sWorkload[BUFF_SZ];
+		char sDevices[BUFF_SZ];
 		sprintf(sPid, "%d", simPid);
+		sprintf(sSeed, "%u", params.seed);
+		sprintf(sInstance, "%d", params.instance);
+		sprintf(sShmFd, "%d", sharedMemoryFd());
+		sprintf(sDoorbell, "%d", replyDoorbell());
+		sprintf(sTransport, "%d", params.replyTransport);
+		sprintf(sGeneration, "%u", generation);
+		sprintf(sInterrupt, "%.17g", params.interruptProbability);
+		sprintf(sWorkload, "%lu", workloadLoops);
+		sprintf(sDevices, "%d", params.numDevices);
 
 		// Execs binary
-		execl(USER_PROG_PATH, USER_PROG_PATH, sPid, NULL);
+		execl(USER_PROG_PATH, USER_PROG_PATH, sPid, sSeed, sInstance,
+		      sShmFd, sDoorbell, sTransport, sGeneration, sInterrupt,
+		      sWorkload, sDevices, NULL);
 		perrorExit("Failed to exec user program");
 	}
+
+	// Records the child so cleanUp only signals this instance's children
+	__atomic_store_n(&childPids[simPid], realPid, __ATOMIC_RELEASE);
+	launched++;
+	watchChildExit(realPid);
+}
+
+// Forks and execs the process that hosts every user process, with -U
+static void launchHost(){
+
+	// Child execs the host
+	if ((hostPid = forkChild(0)) == 0){
+
+		// Converts seed, instance, region and doorbell fds
+		char sSeed[BUFF_SZ];
+		char sInstance[BUFF_SZ];
+		char sShmFd[BUFF_SZ];
+		char sDoorbell[BUFF_SZ];
+		char sTransport[BUFF_SZ];
+		char sInterrupt[BUFF_SZ];
+		char sDevices[BUFF_SZ];
+		sprintf(sSeed, "%u", params.seed);
+		sprintf(sInstance, "%d", params.instance);
+		sprintf(sShmFd, "%d", sharedMemoryFd());
+		sprintf(sDoorbell, "%d", replyDoorbell());
+		sprintf(sTransport, "%d", params.replyTransport);
+		sprintf(sInterrupt, "%.17g", params.interruptProbability);
+		sprintf(sDevices, "%d", params.numDevices);
+
+		// Execs binary
+		execl(USER_HOST_PATH, USER_HOST_PATH, sSeed, sInstance, sShmFd,
+		      sDoorbell, sTransport, sInterrupt, sDevices, NULL);
+		perrorExit("Failed to exec user host");
+	}
+
+	watchChildExit(hostPid);
+}
+
+// Forks a child placed by its launch order, returning 0 in the child
+static pid_t forkChild(int launched){
+	pid_t realPid;
+
+	// Forks or exits on failure using perror
+	if ((realPid = fork()) == -1){
+		perrorExit("Failed to fork");
+	}
+
+	if (realPid == 0){
+
+		// Leaves cleaning up after a failed exec to oss, and lets
+		// cleanUp's SIGQUIT through even if oss inherited it ignored or
+		// the spawn thread, which blocks signals, forked the child
+		sigset_t none;
+		sigemptyset(&none);
+		sigprocmask(SIG_SETMASK, &none, NULL);
+		signal(SIGINT, SIG_DFL);
+		signal(SIGQUIT, SIG_DFL);
+		errorNotifyPid = getppid();
+		placeChild(launched);
+	}
+
+	return realPid;
+}
+
+// Waits for the spawn thread to record the child of pcb, with -M
+static void waitForSpawn(const ProcessControlBlock * pcb){
+	if (!spawnThreadRunning) return;
+
+	while (__atomic_load_n(&spawned[pcb->simPid], __ATOMIC_ACQUIRE)
+	       != pcb->generation)
+		sched_yield();
 }
 
 // Dequeues a PCB, changes state to running, and messages process with quantum
-static ProcessControlBlock * dispatchProcess(Clock * systemClock, MultiQueue * q){
+static ProcessControlBlock * dispatchProcess(Clock * systemClock, MultiQueue * q,
+					     char * msgText){
 	ProcessControlBlock * pcb; // PCB of dispatched process
-	char msgText[MSG_SZ];      // Buffer of message to add to message queue
+	PROFILE_SCOPE(STAGE_DISPATCH);
 
 	// Selects a process control block from the multi-level feedback queue
 	if (q->readyCount > 0)
@@ -229,20 +739,199 @@ static ProcessControlBlock * dispatchProcess(Clock * systemClock, MultiQueue * q
 	else
 		perrorExit("Called dispatchProcess with no ready processes");
 
-	pcb->timeOfLastBurst = *systemClock;
+	pcbAccounting(pcb)->timeOfLastBurst = *systemClock;
 	pcb->state = RUNNING;
 
 	// Messages running process with time quantum
-	sprintf(msgText, "%d", BASE_QUANTUM >> pcb->priority);
-	sendMessage(dispatchMqId, msgText, pcb->simPid + 1);
+	strcpy(msgText, quantumMessages[pcb->schedulingClass][pcb->priority]);
+	if (params.hosted){
+		hostBatch.time = *systemClock;
+		hostBatch.simPid = pcb->simPid;
+		strcpy(hostBatch.quantum, msgText);
+		sendHostMessage(dispatchMqId, &hostBatch);
+		hostBatch.numSpawns = 0;
+	} else if (!params.inProcess){
+		if (params.realExecution){
+			waitForSpawn(pcb);
+			beginRealBurst(pcb, childPids[pcb->simPid],
+				       atoi(msgText));
+		}
+		sendMessage(dispatchMqId, msgText, pcb->simPid + 1);
+	}
 
 	// Logs dispatch
 	logDispatch(pcb->simPid, pcb->priority, *systemClock); 
+	statDispatch(pcb, *systemClock);
 
 	// Returns process control block of dispatched process
 	return pcb;
 }	
 
+// Replaces a dispatch message with the reply of a process simulated by oss,
+// or of its next burst in the -W workload
+static void simulateInProcess(ProcessControlBlock * pcb, char * msgText){
+	if (params.numLockstepConfigs > 0){
+		replayBurst(pcb->simPid, msgText);
+		return;
+	}
+
+	useRandomGenerator(&pcbAccounting(pcb)->generator);
+	simulateBurst(msgText);
+	useRandomGenerator(&ossGenerator);
+}
+
+// Handles events until the reply of the dispatched process arrives, or until
+// its quantum runs out with -X
+static void waitForReply(ProcessControlBlock * pcb, char * msgText,
+			 Clock now){
+	Event event;
+
+	if (params.replyTransport == RING_REPLIES){
+		waitForRingReply(pcb, msgText, now);
+		return;
+	}
+
+	while (!receiveMessageNoWait(interruptMqId, msgText, pcb->simPid + 1)){
+		exitOnSignal();
+		if (!nextEvent(&event, -1)) continue;
+		if (params.realExecution
+		    && expireRealBurst(&event, pcb, msgText))
+			break;
+		handleEvent(&event, now);
+	}
+
+	if (params.realExecution) endRealBurst();
+}
+
+// Drains the completion ring until the dispatched process's reply is in
+static void waitForRingReply(const ProcessControlBlock * pcb, char * msgText,
+			     Clock now){
+	while (!ringReceived[pcb->simPid]){
+		exitOnSignal();
+
+		// Handles exits, timer expiries and commands while it's quiet
+		if (collectRingReplies(HOUSEKEEPING_INTERVAL_MS) == 0)
+			pollEvents(now);
+	}
+
+	memcpy(msgText, ringReplies[pcb->simPid], MSG_SZ);
+	ringReceived[pcb->simPid] = 0;
+}
+
+// Keeps the replies published to the ring, waiting up to timeoutMs for one,
+// and returns the number taken from it
+static int collectRingReplies(int timeoutMs){
+	Completion batch[COMPLETION_RING_SIZE];
+	int i, count;
+
+	count = waitForCompletions(ring, batch, COMPLETION_RING_SIZE,
+				   timeoutMs);
+
+	for (i = 0; i < count; i++){
+
+		// Drops a reply sent by an earlier user of the simPid
+		if (batch[i].generation
+		    != pcbFromSimPid(batch[i].simPid)->generation){
+			fprintf(stderr, "%s: dropped a reply from an ended "
+				"lifetime of simPid %d\n", exeName,
+				batch[i].simPid);
+			continue;
+		}
+
+		memcpy(ringReplies[batch[i].simPid], batch[i].msgText,
+		       MSG_SZ);
+		ringReceived[batch[i].simPid] = 1;
+	}
+
+	return count;
+}
+
+// Handles the events that are already pending, without waiting
+static void pollEvents(Clock now){
+	Event event;
+	PROFILE_SCOPE(STAGE_EVENTS);
+
+	while (nextEvent(&event, 0)) handleEvent(&event, now);
+}
+
+// Responds to one event from the event loop
+static void handleEvent(const Event * event, Clock now){
+	switch (event->type){
+	case REPLY_EVENT:
+		break;		// waitForReply checks the reply queue itself
+	case EXIT_EVENT:
+		reapChild(event->pid);
+		break;
+	case TIMER_EVENT:
+		flushLog();
+		break;
+	case CONTROL_EVENT:
+		runControlCommands(now);
+		break;
+	case QUANTUM_EVENT:
+		break;		// waitForReply ends bursts whose quantum is up
+	}
+}
+
+// Reaps an exited child, exiting if it left before its simulated termination
+static void reapChild(pid_t pid){
+	int i;
+
+	waitpid(pid, NULL, 0);
+
+	if (pid == hostPid){
+		hostPid = 0;
+		fprintf(stderr, "%s: Error: user host exited unexpectedly\n",
+			exeName);
+		cleanUp();
+		exit(1);
+	}
+
+	for (i = 0; i < MAX_BLOCKS; i++){
+		if (__atomic_load_n(&childPids[i], __ATOMIC_ACQUIRE) == pid){
+			childPids[i] = 0;
+
+			// Leaves a child that published its termination to the
+			// ring just before exiting to the processing of it
+			if (params.replyTransport == RING_REPLIES){
+				collectRingReplies(0);
+				if (ringReceived[i]
+				    && ringReplies[i][0] == TERMINATION_CH)
+					return;
+			}
+
+			fprintf(stderr, "%s: Error: user process %d exited"
+				" unexpectedly\n", exeName, i);
+			cleanUp();
+			exit(1);
+		}
+	}
+}
+
+// Carries out the commands written to the control FIFO
+static void runControlCommands(Clock now){
+	char command[BUFF_SZ];
+
+	while (readControlCommand(command, sizeof(command))){
+
+		// Prints the metrics of the run so far
+		if (strcmp(command, "status") == 0)
+			printMetrics(stderr, now);
+
+		// Writes the log out now
+		else if (strcmp(command, "flush") == 0)
+			flushLog();
+
+		// Generates no more processes, finishing once queues drain
+		else if (strcmp(command, "stop") == 0)
+			stopGenerating = 1;
+
+		else
+			fprintf(stderr, "%s: unknown command '%s'\n", exeName,
+				command);
+	}
+}
+
 // Records msg from user process, re-enqueues or removes pcb
 static unsigned int processMessage(const char * msg, ProcessControlBlock * pcb,
 				   MultiQueue * q, Clock currentTime){
@@ -250,22 +939,39 @@ static unsigned int processMessage(const char * msg, ProcessControlBlock * pcb,
 	unsigned int usedNano;	// Number of nanoseconds used by process
 	int r;			// Seconds until an I/O event, if any
 	int s;			// Milliseconds until an I/O event, if any
+	int device;		// Device waited for with -D, or -1
+	PROFILE_SCOPE(STAGE_PROCESS);
 
-	parseMessage(&stateChar, &usedNano, &r, &s, msg);
+	parseMessage(&stateChar, &usedNano, &r, &s, &device, msg);
 
 	// Writes a line to the log indicating pid and burst time
-	logMessageReciept(pcb->simPid, usedNano);
+	logMessageReciept(pcb->simPid, usedNano, currentTime);
 
 	// Updates time figures in pcb
 	Clock usedNanoClock = newClock(0, usedNano);
-	pcb->timeUsedDurringLastBurst = usedNanoClock;
-	incrementClock(&pcb->totalCpuTime, usedNanoClock);
+	pcbAccounting(pcb)->timeUsedDurringLastBurst = usedNanoClock;
+	incrementClock(&pcbAccounting(pcb)->totalCpuTime, usedNanoClock);
+	statBurst(pcb, stateChar, usedNano,
+		  clockSum(currentTime, usedNanoClock));
+	recordBurst(pcb->simPid, pcbAccounting(pcb)->timeOfLastBurst,
+		    pcb->priority, usedNano, stateChar);
+
+	// Adapts the quanta to the burst when asked to, logging any change
+	if (observeBurst(pcb->schedulingClass, pcb->priority, usedNano,
+			 stateChar == USES_ALL_QUANTUM_CH)){
+		stageQuantumMessages();
+		logQuanta(currentTime);
+	}
 
 	// If process terminted, changes state to exit, waits, and frees simPid
 	if (stateChar == TERMINATION_CH){
 		pcb->state = EXIT;
-		wait(NULL);
+
+		waitForSpawn(pcb);
+		childPids[pcb->simPid] = 0; // Reaped when its exit event comes
 		freeInBitVector(pcb->simPid);
+		releaseHistory(pcb->simPid);
+		statTermination(pcb, clockSum(currentTime, usedNanoClock));
 
 		// Writes a line to the log indicating termination
 		logPartialQuantumUse();
@@ -281,6 +987,11 @@ static unsigned int processMessage(const char * msg, ProcessControlBlock * pcb,
 		// Logs the simPid and queue number of re-enqueued pcb
 		logEnqueue(pcb->simPid, pcb->priority);
 
+	// Queues the process on the device it waits for, with s as the track
+	} else if (stateChar == WAITING_FOR_IO_CH && device != -1){
+		requestDevice(q, pcb, device, s,
+			      clockSum(currentTime, usedNanoClock));
+
 	// Adds process to blocked queue, records the time of the I/O event
 	} else if (stateChar == WAITING_FOR_IO_CH){
 		
@@ -313,8 +1024,9 @@ static unsigned int processMessage(const char * msg, ProcessControlBlock * pcb,
 
 // Parses a message received from child process
 void parseMessage(char * stateChar, unsigned int * usedNano, int * r, int * s,
-		  const char * msg){
+		  int * device, const char * msg){
 	int j, i = 0;
+	PROFILE_SCOPE(STAGE_PARSE);
 
 	// Gets state char
 	*stateChar = msg[i];
@@ -352,6 +1064,76 @@ void parseMessage(char * stateChar, unsigned int * usedNano, int * r, int * s,
 		*r = atoi(rBuff);
 		*s = atoi(sBuff);
 	}
+
+	// Gets the device waited for, which follows s with -D
+	*device = -1;
+	if (*stateChar == WAITING_FOR_IO_CH && params.numDevices > 0)
+		*device = atoi(msg + i);
+}
+
+// Reads the checkpoint to resume from and takes the settings of its run
+static void readRestoredSettings(){
+	Parameters given = params; // Settings from the command line
+
+	readCheckpoint(params.restorePath, &checkpoint);
+
+	// Keeps the paths, instance and placement of this invocation, taking
+	// every pointer from it, since the checkpoint's were cleared
+	params = checkpoint.params;
+	takeParameterPointers(&params, &given);
+	params.instance = given.instance;
+	params.inProcess = 1;
+	params.checkpointInterval = given.checkpointInterval;
+	params.ossCpu = given.ossCpu;
+	params.placement = given.placement;
+}
+
+// Restores the state of the run saved in the checkpoint that was read
+static void restoreRun(Clock * systemClock, ProcessControlBlock * processTable,
+		       MultiQueue * q, long * totalGenerated,
+		       Clock * timeToGenerate){
+	*systemClock = checkpoint.systemClock;
+	*totalGenerated = checkpoint.totalGenerated;
+	*timeToGenerate = checkpoint.timeToGenerate;
+	ossGenerator = checkpoint.generator;
+
+	memcpy(processTable, checkpoint.blocks, sizeof(checkpoint.blocks));
+	memcpy(pcbAccounting(processTable), checkpoint.accounting,
+	       sizeof(checkpoint.accounting));
+	*q = checkpoint.multiQueue;
+
+	restoreBitVector(checkpoint.bitVector, checkpoint.nextSimPid);
+	restoreLogPosition(&checkpoint.logPosition);
+	restoreStatistics(&checkpoint.statistics);
+	restoreQuanta(&checkpoint.quanta);
+}
+
+// Copies the state of the run into checkpoint and writes it to the file
+static void takeCheckpoint(Clock now, ProcessControlBlock * processTable,
+			   MultiQueue * q, long totalGenerated,
+			   Clock timeToGenerate){
+	PROFILE_SCOPE(STAGE_CHECKPOINT);
+
+	checkpoint.sequence++;
+	checkpoint.params = params;
+	clearParameterPointers(&checkpoint.params);
+
+	checkpoint.systemClock = now;
+	checkpoint.totalGenerated = totalGenerated;
+	checkpoint.timeToGenerate = timeToGenerate;
+	checkpoint.generator = ossGenerator;
+
+	memcpy(checkpoint.blocks, processTable, sizeof(checkpoint.blocks));
+	memcpy(checkpoint.accounting, pcbAccounting(processTable),
+	       sizeof(checkpoint.accounting));
+	checkpoint.multiQueue = *q;
+	saveBitVector(checkpoint.bitVector, &checkpoint.nextSimPid);
+
+	saveLogPosition(&checkpoint.logPosition);
+	saveStatistics(&checkpoint.statistics);
+	saveQuanta(&checkpoint.quanta);
+
+	writeCheckpoint(&checkpoint);
 }
 
 // Determines the processes response to ctrl + c or alarm
@@ -359,7 +1141,7 @@ static void assignSignalHandlers(){
         struct sigaction sigact;
 
         // Initializes sigaction values
-        sigact.sa_handler = cleanUpAndExit;
+        sigact.sa_handler = recordSignal;
         sigact.sa_flags = 0;
 
         // Assigns signals to sigact
@@ -376,22 +1158,23 @@ static void assignSignalHandlers(){
 	}
 }
 
-// Signal handler - closes files, removes shm, terminates children, and exits
-static void cleanUpAndExit(int param){
+// Signal handler - records the signal for the dispatcher to act on
+//
+// Cleaning up stops the spawn and output threads, which takes locks and
+// pushes to their queues, so it can't be done safely in a handler.
+static void recordSignal(int param){
+	stopSignal = param;
+}
 
-        // Closes files, removes shm, terminates children
-        cleanUp();
+// Closes files, removes shm, terminates children, and exits if a signal came
+static void exitOnSignal(){
+	if (!stopSignal) return;
 
-        // Prints error message
-        char buff[BUFF_SZ];
-        sprintf(buff,
-                 "%s: Error: Terminating after receiving a signal",
-                 exeName
-        );
-        perror(buff);
+	cleanUp();
 
-        // Exits
-        exit(1);
+	fprintf(stderr, "%s: Error: Terminating after receiving a signal\n",
+		exeName);
+	exit(1);
 }
 
 // Ignores interrupts, kills child processes, closes files, removes shared mem
@@ -401,15 +1184,36 @@ static void cleanUp(){
         signal(SIGINT, SIG_IGN);
         signal(SIGQUIT, SIG_IGN);
 
-        // Kills all other processes in the same process group
-        kill(0, SIGQUIT);
+	// Lets the spawn thread finish, so no child is forked after the kills
+	stopSpawnThread();
 
-	// Removes message queue
-	removeMessageQueue(dispatchMqId);      
-	removeMessageQueue(interruptMqId);      
+        // Kills the children of this instance
+	int i;
+	for (i = 0; i < MAX_BLOCKS; i++){
+		if (childPids[i] > 0){
+			kill(childPids[i], SIGQUIT);
+			kill(childPids[i], SIGCONT); // In case -X stopped it
+		}
+	}
+	if (hostPid > 0) kill(hostPid, SIGQUIT);
+
+	// Removes message queues, if they were created
+	if (dispatchMqId != -1) removeMessageQueue(dispatchMqId);
+	if (interruptMqId != -1) removeMessageQueue(interruptMqId);
 	
-	// Detatches from and removes shared memory
-        detach(shm);
-        removeSegment();
+	// Detatches from and removes shared memory, if it was created
+	if (shm != NULL){
+		detach(shm);
+		removeSegment();
+	}
+
+	// Writes the end of the log, trace and history and the last checkpoint
+	closeLog();
+	closeTrace();
+	closeHistory();
+	closeCheckpointFile();
+
+	// Closes event sources and removes the control FIFO
+	closeEventLoop();
 }
 
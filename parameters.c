@@ -0,0 +1,438 @@
+// parameters.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that read scheduler settings
+// from the command line of oss, falling back to the values in constants.h.
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "parameters.h"
+#include "perrorExit.h"
+
+#define OPTIONS "q:l:r:e:p:a:u:s:i:L:m:g:G:k:zt:b:S:Ic:C:R:B:HKT:PMQ:O:A:UXW:" \
+		"D:d:h"
+
+// Settings used by the current run, initialized to the defaults
+Parameters params = {
+	.baseQuantum = BASE_QUANTUM,
+	.numQueueLevels = NUM_QUEUE_LEVELS,
+	.realTimeProbability = REAL_TIME_PROBABILITY,
+	.maxArrivalGap = {maxTimeBetweenNewProcsSecs, maxTimeBetweenNewProcsNS},
+	.interruptProbability = BLOCK_OR_PREEMPT_PROBABILITY,
+
+	.agingEnabled = 0,
+	.promotionWaitThreshold = {PROMOTION_WAIT_TIME_THRESHOLD_SEC,
+				   PROMOTION_WAIT_TIME_THRESHOLD_NS},
+	.utilThresholdScale = 1.0,
+
+	.seed = BASE_SEED,
+	.instance = 0,
+
+	.streaming = 0,
+	.warmUp = {0, 0},
+	.windowLength = {0, 0},
+	.numWindows = 0,
+
+	.logPath = LOG_FILE_NAME,
+	.metricsPath = NULL,
+	.sketchPath = NULL,
+	.logSegmentBytes = 0,
+	.logSegmentSeconds = 0,
+	.logSegmentsKept = 0,
+	.logCompressed = 0,
+	.tracePath = NULL,
+	.historyPath = NULL,
+
+	.inProcess = 0,
+	.hosted = 0,
+	.realExecution = 0,
+	.checkpointPath = NULL,
+	.checkpointInterval = {CHECKPOINT_INTERVAL_SEC, 0},
+	.restorePath = NULL,
+	.numDevices = 0,
+	.numLockstepConfigs = 0,
+
+	.shmBackend = SYSV_SHM,
+	.shmOptions = 0,
+	.shmFd = -1,
+
+	.replyTransport = SYSV_REPLIES,
+	.pipelined = 0,
+	.threaded = 0,
+	.quantumPercentile = 0,
+
+	.ossCpu = -1,
+	.placement = PLACE_ANY,
+	.placementCpus = NULL
+};
+
+// Prints the accepted options to stderr and exits
+static void usage(){
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -q ns     base time quantum (default %d)\n"
+		"  -l n      number of queue levels, 1 to %d (default %d)\n"
+		"  -r p      probability a new process is real time (default %g)\n"
+		"  -e sec    max seconds between new processes (default %u)\n"
+		"  -p p      probability a burst that doesn't terminate blocks"
+		" or is\n"
+		"            preempted (default %g)\n"
+		"  -D dev    adds an I/O device processes block on, given as"
+		" name:fifo or\n"
+		"            name:elevator, then :min-max service ms and"
+		" optionally :seek\n"
+		"            ns per track; repeat for up to %d devices\n"
+		"  -a sec    promote processes waiting sec seconds (aging off"
+		" by default)\n"
+		"  -u x      scales the cpu utilization aging criterion"
+		" (default 1)\n"
+		"  -s seed   seeds oss and user processes (default %d)\n"
+		"  -i n      instance number used to offset IPC keys, below %d,"
+		" or auto\n"
+		"            to use a free one (default 0)\n"
+		"  -S w:l:n  generates processes without limit, measuring n"
+		" windows of l\n"
+		"            seconds after a warm-up of w seconds (n 0 or left"
+		" out for no\n"
+		"            limit)\n"
+		"  -L path   log file (default %s)\n"
+		"  -m path   writes run metrics to path at exit\n"
+		"  -d path   writes quantile sketches of each class and level"
+		" to path\n"
+		"            at exit, to merge with ossmerge\n"
+		"  -g size   starts a log segment every size bytes"
+		" (k, m or g)\n"
+		"  -G sec    starts a log segment every sec seconds\n"
+		"  -k n      keeps only the newest n log segments\n"
+		"  -z        compresses the log\n"
+		"  -t path   writes the timeline as Chrome trace-event JSON\n"
+		"  -b path   writes every burst of each process to path\n"
+		"  -I        simulates user processes inside oss\n"
+		"  -U        simulates user processes as coroutines of one"
+		" host process\n"
+		"  -X        runs a real workload for each burst, enforcing"
+		" quanta\n"
+		"  -c path   checkpoints to path, implies -I\n"
+		"  -C sec    simulated seconds between checkpoints"
+		" (default %d)\n"
+		"  -R path   resumes from the checkpoint in path, implies -I\n"
+		"  -W opts   also simulates the workload with opts added,"
+		" implies -I;\n"
+		"            repeat to compare up to %d configurations\n"
+		"  -B kind   shared memory: sysv, posix or memfd"
+		" (default sysv)\n"
+		"  -H        backs posix or memfd shared memory with huge"
+		" pages\n"
+		"  -K        locks posix or memfd shared memory in ram\n"
+		"  -T kind   replies by sysv message queue or shared ring"
+		" (default sysv)\n"
+		"  -P        pipelines work for the next iteration with each"
+		" burst\n"
+		"  -M        forks children and writes the log on threads of"
+		" their own\n"
+		"  -Q p      adapts quanta to the p-th percentile of bursts,"
+		" p < 1\n"
+		"            (default 0, fixed quanta)\n"
+		"  -O cpu    pins oss to cpu\n"
+		"  -A policy places user processes: any, cpuset:cpus, siblings,"
+		" llc,\n"
+		"            node or spread[:cpus] (default any)\n",
+		exeName, BASE_QUANTUM, MAX_QUEUE_LEVELS, NUM_QUEUE_LEVELS,
+		REAL_TIME_PROBABILITY, maxTimeBetweenNewProcsSecs,
+		BLOCK_OR_PREEMPT_PROBABILITY, MAX_DEVICES, BASE_SEED,
+		MAX_INSTANCES, LOG_FILE_NAME,
+		CHECKPOINT_INTERVAL_SEC, MAX_LOCKSTEP_CONFIGS);
+	exit(1);
+}
+
+// Returns a size like 64k or 16m in bytes, or -1 if it is invalid
+static long parseSize(const char * size){
+	const char * units = "kmg";	// Each 1024 times the last
+	char * end, * unit;
+	long bytes = strtol(size, &end, 10);
+
+	if (*end != '\0' && (unit = strchr(units, tolower(*end))) != NULL){
+		bytes <<= 10 * (unit - units + 1);
+		end++;
+	}
+
+	return *end == '\0' && end != size ? bytes : -1;
+}
+
+// Fills device from name:discipline:min-max[:seek], returning 0 if spec is
+// invalid. The name is left in spec.
+static int parseDevice(char * spec, DeviceSpec * device){
+	char * discipline, * times;
+	int minMs, maxMs, seekNs = 0, length;
+
+	// Splits the name and discipline from the times
+	if ((discipline = strchr(spec, ':')) == NULL
+	    || (times = strchr(discipline + 1, ':')) == NULL)
+		return 0;
+	*discipline++ = '\0';
+	*times++ = '\0';
+
+	if (strcmp(discipline, "fifo") == 0)
+		device->discipline = FIFO_DEVICE;
+	else if (strcmp(discipline, "elevator") == 0)
+		device->discipline = ELEVATOR_DEVICE;
+	else
+		return 0;
+
+	// Reads the service times and the seek time, if given
+	if (sscanf(times, "%d-%d%n", &minMs, &maxMs, &length) != 2
+	    || (times[length] == ':'
+		&& sscanf(times + length + 1, "%d", &seekNs) != 1)
+	    || (times[length] != ':' && times[length] != '\0')
+	    || *spec == '\0' || strlen(spec) >= DEVICE_NAME_SZ
+	    || minMs < 0 || maxMs < minMs || seekNs < 0)
+		return 0;
+
+	strcpy(device->name, spec);
+	device->minService = newClock(minMs / 1000, minMs % 1000 * MILLION);
+	device->maxService = newClock(maxMs / 1000, maxMs % 1000 * MILLION);
+	device->seekNs = seekNs;
+
+	return 1;
+}
+
+// Sets values in params from the argument vector, exiting on invalid input
+void parseParameters(int argc, char * argv[]){
+	int opt, policy, warmUp, windowLength;
+	char * cpus;
+
+	while ((opt = getopt(argc, argv, OPTIONS)) != -1){
+		switch (opt){
+		case 'q':
+			params.baseQuantum = strtoul(optarg, NULL, 10);
+			break;
+		case 'l':
+			params.numQueueLevels = atoi(optarg);
+			break;
+		case 'r':
+			params.realTimeProbability = atof(optarg);
+			break;
+		case 'e':
+			params.maxArrivalGap = newClock(atoi(optarg), 0);
+			break;
+		case 'p':
+			params.interruptProbability = atof(optarg);
+			break;
+		case 'D':
+			if (params.numDevices == MAX_DEVICES
+			    || !parseDevice(optarg,
+					    &params.devices[params.numDevices]))
+				usage();
+			params.numDevices++;
+			break;
+		case 'a':
+			params.agingEnabled = 1;
+			params.promotionWaitThreshold = newClock(atoi(optarg), 0);
+			break;
+		case 'u':
+			params.utilThresholdScale = atof(optarg);
+			break;
+		case 's':
+			params.seed = strtoul(optarg, NULL, 10);
+			break;
+		case 'i':
+			if (strcmp(optarg, "auto") == 0)
+				params.instance = AUTO_INSTANCE;
+			else
+				params.instance = atoi(optarg);
+			break;
+		case 'L':
+			params.logPath = optarg;
+			break;
+		case 'm':
+			params.metricsPath = optarg;
+			break;
+		case 'd':
+			params.sketchPath = optarg;
+			break;
+		case 'g':
+			params.logSegmentBytes = parseSize(optarg);
+			break;
+		case 'G':
+			params.logSegmentSeconds = atoi(optarg);
+			break;
+		case 'k':
+			params.logSegmentsKept = atoi(optarg);
+			break;
+		case 'z':
+			params.logCompressed = 1;
+			break;
+		case 't':
+			params.tracePath = optarg;
+			break;
+		case 'b':
+			params.historyPath = optarg;
+			break;
+		case 'I':
+			params.inProcess = 1;
+			break;
+		case 'c':
+			params.inProcess = 1;
+			params.checkpointPath = optarg;
+			break;
+		case 'C':
+			params.checkpointInterval = newClock(atoi(optarg), 0);
+			break;
+		case 'S':
+			params.streaming = 1;
+			warmUp = windowLength = -1;
+			sscanf(optarg, "%d:%d:%d", &warmUp, &windowLength,
+			       &params.numWindows);
+			if (warmUp >= 0 && windowLength > 0){
+				params.warmUp = newClock(warmUp, 0);
+				params.windowLength = newClock(windowLength, 0);
+			}
+			break;
+		case 'R':
+			params.inProcess = 1;
+			params.restorePath = optarg;
+			break;
+		case 'W':
+			if (params.numLockstepConfigs == MAX_LOCKSTEP_CONFIGS)
+				usage();
+			params.inProcess = 1;
+			params.lockstepConfigs[params.numLockstepConfigs++] =
+				optarg;
+			break;
+		case 'B':
+			if (strcmp(optarg, "sysv") == 0)
+				params.shmBackend = SYSV_SHM;
+			else if (strcmp(optarg, "posix") == 0)
+				params.shmBackend = POSIX_SHM;
+			else if (strcmp(optarg, "memfd") == 0)
+				params.shmBackend = MEMFD_SHM;
+			else
+				usage();
+			break;
+		case 'H':
+			params.shmOptions |= SHM_OPT_HUGE_PAGES;
+			break;
+		case 'K':
+			params.shmOptions |= SHM_OPT_LOCKED;
+			break;
+		case 'U':
+			params.hosted = 1;
+			break;
+		case 'X':
+			params.realExecution = 1;
+			break;
+		case 'P':
+			params.pipelined = 1;
+			break;
+		case 'M':
+			params.threaded = 1;
+			break;
+		case 'Q':
+			params.quantumPercentile = atof(optarg);
+			if (params.quantumPercentile < 0
+			    || params.quantumPercentile >= 1)
+				usage();
+			break;
+		case 'O':
+			params.ossCpu = atoi(optarg);
+			break;
+		case 'A':
+			// Splits the cpu list from the policy name
+			if ((cpus = strchr(optarg, ':')) != NULL){
+				*cpus = '\0';
+				params.placementCpus = cpus + 1;
+			}
+			if ((policy = placementPolicy(optarg)) == -1)
+				usage();
+			params.placement = policy;
+			break;
+		case 'T':
+			if (strcmp(optarg, "sysv") == 0)
+				params.replyTransport = SYSV_REPLIES;
+			else if (strcmp(optarg, "ring") == 0)
+				params.replyTransport = RING_REPLIES;
+			else
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	// Rejects settings the multi-level queue can't represent
+	if (params.numQueueLevels < 1
+	    || params.numQueueLevels > MAX_QUEUE_LEVELS
+	    || (params.baseQuantum >> (params.numQueueLevels - 1)) == 0
+	    || params.realTimeProbability < 0
+	    || params.realTimeProbability > 1
+	    || params.interruptProbability < 0
+	    || params.interruptProbability > 1
+	    || params.instance < AUTO_INSTANCE
+	    || params.instance >= MAX_INSTANCES
+	    || params.checkpointInterval.seconds == 0
+	    || (params.shmOptions != 0 && params.shmBackend == SYSV_SHM)
+	    || ((params.pipelined || params.threaded)
+		&& (params.checkpointPath != NULL
+		    || params.restorePath != NULL))
+	    || params.logSegmentBytes < 0
+	    || params.logSegmentSeconds < 0
+	    || params.logSegmentsKept < 0
+	    || (params.logSegmentsKept > 0 && params.logSegmentBytes == 0
+		&& params.logSegmentSeconds == 0)
+	    || (params.tracePath != NULL && params.restorePath != NULL)
+	    || (params.historyPath != NULL && params.restorePath != NULL)
+	    || (params.hosted && params.inProcess)
+	    || (params.numDevices > 0 && (params.checkpointPath != NULL
+					  || params.restorePath != NULL))
+	    || (params.numLockstepConfigs > 0
+		&& (params.streaming || params.checkpointPath != NULL
+		    || params.restorePath != NULL))
+	    || (params.realExecution && (params.inProcess || params.hosted
+					 || params.replyTransport
+					    == RING_REPLIES))
+	    || (params.streaming && (params.windowLength.seconds == 0
+				     || params.numWindows < 0
+				     || params.checkpointPath != NULL
+				     || params.restorePath != NULL))
+	    || params.ossCpu < -1
+	    || (params.placement == PLACE_CPUSET
+		&& params.placementCpus == NULL)
+	    || (params.placementCpus != NULL
+		&& params.placement != PLACE_CPUSET
+		&& params.placement != PLACE_SPREAD))
+		usage();
+}
+
+// Sets every pointer in p to the one in from. A pointer added to Parameters
+// must be added here, since a Parameters read from a checkpoint was written by
+// another process and must point only at memory of this one.
+void takeParameterPointers(Parameters * p, const Parameters * from){
+	int i;
+
+	p->logPath = from->logPath;
+	p->metricsPath = from->metricsPath;
+	p->sketchPath = from->sketchPath;
+	p->tracePath = from->tracePath;
+	p->historyPath = from->historyPath;
+	p->checkpointPath = from->checkpointPath;
+	p->restorePath = from->restorePath;
+	for (i = 0; i < MAX_LOCKSTEP_CONFIGS; i++)
+		p->lockstepConfigs[i] = from->lockstepConfigs[i];
+	p->placementCpus = from->placementCpus;
+}
+
+// Sets every pointer in p to NULL, leaving only settings a file can hold
+void clearParameterPointers(Parameters * p){
+	static const Parameters none;	// Every pointer NULL
+
+	takeParameterPointers(p, &none);
+}
+
+// Returns the IPC key of this run corresponding to a key from constants.h
+int instanceKey(int baseKey){
+	return baseKey + params.instance;
+}
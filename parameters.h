@@ -0,0 +1,97 @@
+// parameters.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the Parameters type, which holds the
+// scheduler settings that may be overridden on the command line of oss, and
+// headers for functions that parse and use them. Defaults come from
+// constants.h.
+
+#ifndef PARAMETERS_H
+#define PARAMETERS_H
+
+#include "clock.h"
+#include "constants.h"
+#include "placement.h"
+#include "sharedMemory.h"
+
+// How user processes send replies to oss
+typedef enum ReplyTransport {SYSV_REPLIES, RING_REPLIES} ReplyTransport;
+
+// How a simulated I/O device picks the next request it serves
+typedef enum DeviceDiscipline {FIFO_DEVICE, ELEVATOR_DEVICE} DeviceDiscipline;
+
+// A simulated I/O device given with -D
+typedef struct deviceSpec {
+	char name[DEVICE_NAME_SZ];
+	DeviceDiscipline discipline;
+	Clock minService;		// Shortest service time, before seeking
+	Clock maxService;		// Longest service time, before seeking
+	unsigned int seekNs;		// Time the head takes to cross a track
+} DeviceSpec;
+
+typedef struct parameters {
+	unsigned int baseQuantum;	// Quantum of the highest priority queue
+	int numQueueLevels;		// Levels used in the multi-level queue
+	double realTimeProbability;	// Probability new process is real time
+	Clock maxArrivalGap;		// Max time between new processes
+	double interruptProbability;	// Probability a burst that doesn't
+					// terminate blocks or is preempted
+	DeviceSpec devices[MAX_DEVICES]; // Devices processes block on
+	int numDevices;			// Devices given, or 0 for timed waits
+
+	int agingEnabled;		// Nonzero if aged processes are promoted
+	Clock promotionWaitThreshold;	// Aging criterion for wait time
+	double utilThresholdScale;	// Multiplies the cpu use criterion
+
+	unsigned int seed;		// Seeds oss and its user processes
+	int instance;			// Offsets IPC keys of this run
+
+	int streaming;			// Nonzero if arrivals never stop
+	Clock warmUp;			// Time before the measurement begins
+	Clock windowLength;		// Length of each measurement window
+	int numWindows;			// Windows measured, or 0 for no limit
+
+	char * logPath;			// Path of the log file
+	char * metricsPath;		// Path of the metrics file, if any
+	char * sketchPath;		// Path of the sketch file, if any
+	long logSegmentBytes;		// Size that ends a log segment, or 0
+	int logSegmentSeconds;		// Age that ends a log segment, or 0
+	int logSegmentsKept;		// Newest segments kept, or 0 for all
+	int logCompressed;		// Nonzero if the log is compressed
+	char * tracePath;		// Path of the trace-event file, if any
+	char * historyPath;		// Path of the burst history, if any
+
+	int inProcess;			// Nonzero if oss runs bursts itself
+	int hosted;			// Nonzero if one process hosts every
+					// user process as a coroutine
+	int realExecution;		// Nonzero if bursts run for real
+	char * checkpointPath;		// Path of the checkpoint file, if any
+	Clock checkpointInterval;	// Simulated time between checkpoints
+	char * restorePath;		// Checkpoint file to resume from, if any
+	char * lockstepConfigs[MAX_LOCKSTEP_CONFIGS]; // Options of each -W
+	int numLockstepConfigs;		// Configurations compared with -W
+
+	ShmBackend shmBackend;		// Kind of shared memory region used
+	int shmOptions;			// SHM_OPT_ flags of a mapped region
+	int shmFd;			// Region inherited by a child, or -1
+
+	ReplyTransport replyTransport;	// How user processes send replies
+	int pipelined;			// Nonzero if oss works ahead in bursts
+	int threaded;			// Nonzero if spawning and output run
+					// on threads of their own
+	double quantumPercentile;	// Burst percentile quanta adapt to, or 0
+
+	int ossCpu;			// Cpu oss is pinned to, or -1
+	PlacementPolicy placement;	// Where user processes run
+	char * placementCpus;		// Cpu list of the policy, if given
+} Parameters;
+
+#define AUTO_INSTANCE -1	// Instance number oss picks for itself
+
+extern Parameters params;
+
+void parseParameters(int argc, char * argv[]);
+void takeParameterPointers(Parameters * p, const Parameters * from);
+void clearParameterPointers(Parameters * p);
+int instanceKey(int baseKey);
+
+#endif
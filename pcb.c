@@ -1,47 +1,103 @@
 // pcb.c was created by Mark Renard on 3/28/2020.
 //
 // This file contains an implementation of a function that returns a process
-// control block in its initial state.
+// control block in its initial state, and of functions that reach blocks by
+// simPid and use the accounting record kept for each block in a separate
+// array.
+
+#include <stddef.h>
 
 #include "pcb.h"
 
+static ProcessControlBlock * blockTable = NULL;	  // Indexed by simPid
+static ProcessAccounting * accountingTable = NULL; // Indexed by simPid
+
 // Returns an initialized process control block
-ProcessControlBlock initialProcessControlBlock(int simPid, Clock currentTime,
+ProcessControlBlock initialProcessControlBlock(int simPid,
+					       unsigned int generation,
 					       SchedulingClass schedulingClass){
 	ProcessControlBlock pcb;
 
-	// Sets logical pid, timeCreated, and schedulingClass to argument values
+	// Sets logical pid, generation and schedulingClass to argument values
 	pcb.simPid = simPid;
-	pcb.timeCreated = currentTime;
+	pcb.generation = generation;
 	pcb.schedulingClass = schedulingClass;
-	
+
 	// Initializes priority to 1 for normal, 0 for real-time
 	pcb.priority = schedulingClass == NORMAL ? 1 : 0;
 
-	// Clocks initialized to zero
-	pcb.timeOfLastBurst = zeroClock();
-	pcb.timeUsedDurringLastBurst = zeroClock();
-	pcb.totalCpuTime = zeroClock();
 	pcb.nextIoEventTime = zeroClock();
 
 	pcb.state = NEW;
+	pcb.burst = 0;
+
+	return pcb;
+}
+
+// Returns an initialized accounting record for a process created now
+ProcessAccounting initialProcessAccounting(Clock currentTime){
+	ProcessAccounting accounting;
+
+	accounting.timeCreated = currentTime;
 
-	pcb.previous = NULL;	// No previous block, not in queue yet
+	// Clocks initialized to zero
+	accounting.timeOfLastBurst = zeroClock();
+	accounting.timeUsedDurringLastBurst = zeroClock();
+	accounting.totalCpuTime = zeroClock();
+	accounting.ioRequestTime = zeroClock();
+	accounting.ioTrack = 0;
+
+	return accounting;
+}
+
+// Sets the arrays used by pcbFromSimPid and pcbAccounting
+void setProcessTable(ProcessControlBlock * blocks,
+		     ProcessAccounting * accounting){
+	blockTable = blocks;
+	accountingTable = accounting;
+}
+
+// Returns the process control block with a simPid
+ProcessControlBlock * pcbFromSimPid(int simPid){
+	return &blockTable[simPid];
+}
+
+// Returns a handle to the current lifetime of a process control block
+unsigned int pcbHandle(const ProcessControlBlock * pcb){
+	return pcb->generation << HANDLE_SIMPID_BITS | pcb->simPid;
+}
+
+// Returns the block of a handle, or NULL if the handle's lifetime is over
+ProcessControlBlock * pcbFromHandle(unsigned int handle){
+	ProcessControlBlock * pcb = &blockTable[handle & HANDLE_SIMPID_MASK];
+
+	if (pcb->generation << HANDLE_SIMPID_BITS
+	    != (handle & ~HANDLE_SIMPID_MASK))
+		return NULL;
 
 	return pcb;
 }
 
+// Returns the accounting record of a process control block
+ProcessAccounting * pcbAccounting(const ProcessControlBlock * pcb){
+	return &accountingTable[pcb->simPid];
+}
+
 
 Clock pcbTimeLastExecuting(const ProcessControlBlock * pcb){
-	return clockSum(pcb->timeOfLastBurst, pcb->timeUsedDurringLastBurst);
+	const ProcessAccounting * accounting = pcbAccounting(pcb);
+
+	return clockSum(accounting->timeOfLastBurst,
+			accounting->timeUsedDurringLastBurst);
 }
 
 
 Clock pcbTimeInSystem(const ProcessControlBlock * pcb, Clock currentTime){
-	return clockDiff(currentTime, pcb->timeCreated);
+	return clockDiff(currentTime, pcbAccounting(pcb)->timeCreated);
 }
 
 
 double pcbCpuUtilization(const ProcessControlBlock * pcb, Clock currentTime){
-	return clockRatio(pcb->totalCpuTime, pcbTimeInSystem(pcb, currentTime));
+	return clockRatio(pcbAccounting(pcb)->totalCpuTime,
+			  pcbTimeInSystem(pcb, currentTime));
 }
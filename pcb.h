@@ -3,24 +3,59 @@
 // This file contains a definition of the ProcessControlBlock data type and
 // the function header for a function that returns a ProcessControlBlock in its
 // default initial state.
+//
+// The process table is split in two. ProcessControlBlocks hold the fields
+// used to schedule a process and occupy one cache line each, so oss updating
+// one block never invalidates the line a spinning child reads. The
+// accounting fields, which only oss touches at the ends of bursts, are kept in
+// a separate array of ProcessAccounting records reached with pcbAccounting.
+//
+// A simPid is reused once its process terminates, so each block counts the
+// lifetimes its simPid has had. Queues hold handles that pair the simPid with
+// that generation, and pcbFromHandle returns NULL for a handle whose lifetime
+// is over instead of a block that now belongs to another process.
 
 #ifndef PCB_H
 #define PCB_H
 
 #include "clock.h"
+#include "constants.h"
+#include "randomGen.h"
 
 typedef enum ProcessState {NEW, READY, RUNNING, BLOCKED, PREEMPTED, EXIT} ProcessState;
 typedef enum SchedulingClass {NORMAL, REAL_TIME} SchedulingClass;
 
+#define HANDLE_SIMPID_BITS 8	// Low bits of a handle holding the simPid
+#define HANDLE_SIMPID_MASK ((1U << HANDLE_SIMPID_BITS) - 1)
+
+_Static_assert(MAX_BLOCKS <= 1 << HANDLE_SIMPID_BITS,
+	       "simPids must fit in HANDLE_SIMPID_BITS");
+
 typedef struct processControlBlock {
 
+	// Updated at dispatch and end of burst, read by the spinning child
+	volatile ProcessState state;	 // The simulated state of the process
+
+	// Even while a burst runs with -X, made odd by whoever ends it first
+	unsigned int burst;		 // Sequence number of the burst
+
+	// Updated by multi-level feedback queue
+	int priority;			 // Priority level of the process
+
 	// Determined at process generation time
 	int simPid;			 // Simulated process identifier
-	Clock timeCreated;		 // Used to compute total time in system
+	unsigned int generation;	 // Lifetimes of the simPid, from 1
 	SchedulingClass schedulingClass; // Whether process is real time
 
-	// Updated by multi-level feedback queue
-	int priority;			 // Priority level of the process
+	// Updated at end of burst, the deadline of a blocked process
+	Clock nextIoEventTime;		 // Time of next I/O event
+
+} __attribute__((aligned(CACHE_LINE_SIZE))) ProcessControlBlock;
+
+typedef struct processAccounting {
+
+	// Determined at process generation time
+	Clock timeCreated;		 // Used to compute total time in system
 
 	// Updated at dispatch time
 	Clock timeOfLastBurst;		 // Time the last cpu burst started
@@ -28,17 +63,24 @@ typedef struct processControlBlock {
 	// Updated at end of burst
 	Clock timeUsedDurringLastBurst;	 // Time passed durring last execution
 	Clock totalCpuTime;		 // Total simulated execution time
-	Clock nextIoEventTime;		 // Time of next I/O event
 
-	// Updated at dispatch and end of burst
-	ProcessState state;		 // The simulated state of the process
+	// Set when the process requests a device with -D
+	int ioTrack;			 // Track of the device it waits for
+	Clock ioRequestTime;		 // Time it began waiting
 
-	// Link to the previous process control block in its queue
-	struct processControlBlock * previous;
+	// Draws the bursts of the process when oss simulates it in-process
+	RandomGenerator generator;
 
-} ProcessControlBlock;
+} ProcessAccounting;
 
-ProcessControlBlock initialProcessControlBlock(int, Clock, SchedulingClass);
+ProcessControlBlock initialProcessControlBlock(int, unsigned int,
+					       SchedulingClass);
+ProcessAccounting initialProcessAccounting(Clock);
+void setProcessTable(ProcessControlBlock *, ProcessAccounting *);
+ProcessControlBlock * pcbFromSimPid(int simPid);
+unsigned int pcbHandle(const ProcessControlBlock *);
+ProcessControlBlock * pcbFromHandle(unsigned int handle);
+ProcessAccounting * pcbAccounting(const ProcessControlBlock *);
 Clock pcbTimeLastExecuting(const ProcessControlBlock *);
 Clock pcbTimeInSystem(const ProcessControlBlock *, Clock currentTime);
 double pcbCpuUtilization(const ProcessControlBlock *, Clock currentTime);
@@ -0,0 +1,241 @@
+// pcbBench.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a benchmark of dispatch latency with two layouts of the
+// process table: the original one, with every field of a process control
+// block packed together, and the split one in pcb.h, with scheduling fields
+// on a cache line per block and accounting fields in a separate array.
+//
+// Children spin reading the state of their own block, as user processes do.
+// For each dispatch the parent does the bookkeeping oss does, sets the
+// state to RUNNING, and times how long the child takes to notice. With the
+// packed layout the parent's writes to neighbouring blocks invalidate the
+// cache lines the children spin on.
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "pcb.h"
+#include "perrorExit.h"
+#include "seqlock.h"
+
+#define DEFAULT_CHILDREN 8
+#define DEFAULT_ROUNDS 20000
+
+// The process control block as it was before the hot/cold split
+typedef struct packedBlock {
+	int simPid;
+	Clock timeCreated;
+	SchedulingClass schedulingClass;
+	int priority;
+	Clock timeOfLastBurst;
+	Clock timeUsedDurringLastBurst;
+	Clock totalCpuTime;
+	Clock nextIoEventTime;
+	volatile ProcessState state;
+	struct packedBlock * previous;
+} PackedBlock;
+
+// Acknowledgement written by each child, one cache line apiece
+typedef struct ack {
+	volatile long round;
+} __attribute__((aligned(CACHE_LINE_SIZE))) Ack;
+
+static volatile ProcessState * stateOf(int layout, int i);
+static void beginBurst(int layout, int i, Clock now);
+static void endBurst(int layout, int i, Clock used);
+static void child(int layout, int i);
+static long benchmark(int layout, long * latencies);
+static long nanoseconds();
+static int compareLongs(const void * a, const void * b);
+
+static int numChildren = DEFAULT_CHILDREN;
+static long rounds = DEFAULT_ROUNDS;
+static int yield = 0;		// Nonzero if spinners must share cpus
+
+// Tables in memory shared with the children
+static PackedBlock * packed;
+static ProcessControlBlock * hot;
+static ProcessAccounting * cold;
+static Ack * acks;
+
+static const char * layoutNames[] = {"packed", "split"};
+
+int main(int argc, char * argv[]){
+	long * latencies;
+	int opt, layout;
+	size_t size;
+	char * region;
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "c:r:")) != -1){
+		switch (opt){
+		case 'c':
+			numChildren = atoi(optarg);
+			break;
+		case 'r':
+			rounds = atol(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-c children] [-r rounds]\n",
+				exeName);
+			exit(1);
+		}
+	}
+	if (numChildren < 1 || numChildren > MAX_BLOCKS) numChildren = 1;
+
+	// Spinning children yield if there aren't enough cpus for all of them
+	yield = sysconf(_SC_NPROCESSORS_ONLN) <= numChildren;
+
+	// Maps both layouts and the acknowledgements in one shared region
+	size = sizeof(PackedBlock) * MAX_BLOCKS
+	       + sizeof(ProcessControlBlock) * MAX_BLOCKS
+	       + sizeof(ProcessAccounting) * MAX_BLOCKS
+	       + sizeof(Ack) * MAX_BLOCKS;
+	region = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED)
+		perrorExit("Failed to map shared memory");
+
+	acks = (Ack *) region;
+	hot = (ProcessControlBlock *) (acks + MAX_BLOCKS);
+	cold = (ProcessAccounting *) (hot + MAX_BLOCKS);
+	packed = (PackedBlock *) (cold + MAX_BLOCKS);
+
+	if ((latencies = malloc(sizeof(long) * rounds * numChildren)) == NULL)
+		perrorExit("Failed to allocate latencies");
+
+	printf("%d children, %ld dispatches each%s\n", numChildren, rounds,
+	       yield ? ", spinners yield" : "");
+	printf("%-8s %10s %10s %10s %10s\n", "layout", "mean ns", "p50 ns",
+	       "p99 ns", "p99.9 ns");
+
+	for (layout = 0; layout < 2; layout++){
+		long n = benchmark(layout, latencies);
+		long total = 0, i;
+
+		for (i = 0; i < n; i++) total += latencies[i];
+		qsort(latencies, n, sizeof(long), compareLongs);
+
+		printf("%-8s %10ld %10ld %10ld %10ld\n", layoutNames[layout],
+		       total / n, latencies[n / 2], latencies[n * 99 / 100],
+		       latencies[n * 999 / 1000]);
+	}
+
+	munmap(region, size);
+	return 0;
+}
+
+// Returns the state field of block i in a layout
+static volatile ProcessState * stateOf(int layout, int i){
+	return layout == 0 ? &packed[i].state : &hot[i].state;
+}
+
+// Does the writes oss does when dispatching block i
+static void beginBurst(int layout, int i, Clock now){
+	if (layout == 0){
+		packed[i].timeOfLastBurst = now;
+		packed[i].state = RUNNING;
+	} else {
+		cold[i].timeOfLastBurst = now;
+		hot[i].state = RUNNING;
+	}
+}
+
+// Does the writes oss does when a burst of block i ends
+static void endBurst(int layout, int i, Clock used){
+	if (layout == 0){
+		packed[i].timeUsedDurringLastBurst = used;
+		incrementClock(&packed[i].totalCpuTime, used);
+		packed[i].state = READY;
+	} else {
+		cold[i].timeUsedDurringLastBurst = used;
+		incrementClock(&cold[i].totalCpuTime, used);
+		hot[i].state = READY;
+	}
+}
+
+// Spins on block i, acknowledging each dispatch, until it is told to exit
+static void child(int layout, int i){
+	volatile ProcessState * state = stateOf(layout, i);
+	long round = 0;
+
+	for (;;){
+		// Waits to be dispatched, as userProgram does
+		while (*state != RUNNING && *state != EXIT)
+			if (yield) sched_yield(); else CPU_RELAX();
+
+		if (*state == EXIT) _exit(0);
+
+		acks[i].round = ++round;
+
+		// Waits for the burst to be ended by the parent
+		while (*state == RUNNING)
+			if (yield) sched_yield(); else CPU_RELAX();
+	}
+}
+
+// Runs all dispatches with one layout, returning the number of latencies
+static long benchmark(int layout, long * latencies){
+	Clock now = zeroClock();
+	long round, n = 0, start;
+	int i;
+
+	// Initializes the tables
+	memset(packed, 0, sizeof(PackedBlock) * MAX_BLOCKS);
+	memset(hot, 0, sizeof(ProcessControlBlock) * MAX_BLOCKS);
+	memset(cold, 0, sizeof(ProcessAccounting) * MAX_BLOCKS);
+	memset((void *) acks, 0, sizeof(Ack) * MAX_BLOCKS);
+	for (i = 0; i < numChildren; i++) *stateOf(layout, i) = READY;
+
+	// Launches children
+	for (i = 0; i < numChildren; i++){
+		pid_t pid = fork();
+		if (pid == -1) perrorExit("Failed to fork");
+		if (pid == 0) child(layout, i);
+	}
+
+	// Dispatches each child in turn
+	for (round = 1; round <= rounds; round++){
+		for (i = 0; i < numChildren; i++){
+			incrementClock(&now, newClock(0, MIN_SCHEDULING_TIME_NS));
+
+			start = nanoseconds();
+			beginBurst(layout, i, now);
+			while (acks[i].round != round)
+				if (yield) sched_yield(); else CPU_RELAX();
+			latencies[n++] = nanoseconds() - start;
+
+			endBurst(layout, i, newClock(0, BASE_QUANTUM));
+		}
+	}
+
+	// Stops children
+	for (i = 0; i < numChildren; i++) *stateOf(layout, i) = EXIT;
+	for (i = 0; i < numChildren; i++) wait(NULL);
+
+	return n;
+}
+
+// Returns the time on the monotonic clock in nanoseconds
+static long nanoseconds(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * (long) BILLION + ts.tv_nsec;
+}
+
+// Orders longs for qsort
+static int compareLongs(const void * a, const void * b){
+	long x = *(const long *) a, y = *(const long *) b;
+	return (x > y) - (x < y);
+}
@@ -1,17 +1,53 @@
 // perrorExit.c was created by Mark Renard on 2/21/2020
 
+#define _GNU_SOURCE
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <signal.h>
+#include <sys/syscall.h>
 
 char * exeName;
+pid_t errorNotifyPid = 0; // Process also interrupted on error, if nonzero
+void (* errorCleanUp)() = NULL; // Run by the main thread before exiting
+
+static pthread_t failedThread;	// Helper thread stopped by an error, if any
+static int helperFailed = 0;	// Nonzero once failedThread is set
 
 // This function prints an error message in a standard format and exits.
 void perrorExit(char * msg){
+	static int exiting = 0;	// Nonzero once the main thread is cleaning up
 	char errmsg[100];
 	sprintf(errmsg, "%s: Error: %s", exeName, msg);
 	perror(errmsg);
 
-	kill(0, SIGINT);
+	// Interrupts the process responsible for cleaning up
+	if (errorNotifyPid > 0) kill(errorNotifyPid, SIGINT);
+
+	// A helper thread interrupts the main thread, which cleans up, and
+	// stops where it is. Its signals are blocked, so pause never returns.
+	if (getpid() != syscall(SYS_gettid)){
+		failedThread = pthread_self();
+		__atomic_store_n(&helperFailed, 1, __ATOMIC_RELEASE);
+		kill(getpid(), SIGINT);
+		for (;;) pause();
+	}
+
+	// Exits at once if cleaning up failed too
+	if (errorCleanUp != NULL && !exiting){
+		exiting = 1;
+		errorCleanUp();
+	}
+	exit(1);
+}
+
+// Returns nonzero if a helper thread stopped in perrorExit
+int anyThreadFailed(){
+	return __atomic_load_n(&helperFailed, __ATOMIC_ACQUIRE);
+}
+
+// Returns nonzero if thread stopped in perrorExit, so no one should wait on it
+int threadFailed(pthread_t thread){
+	return anyThreadFailed() && pthread_equal(thread, failedThread);
 }
@@ -2,6 +2,20 @@
 //
 // This file contains a header for a function which outputs an error message
 // in a standard format using perror and then exits with error code 1.
+//
+// perrorExit never returns. On the main thread it runs errorCleanUp, if a
+// program set one, and exits. A helper thread instead raises SIGINT for the
+// main thread to clean up and stops for good, so threadFailed tells cleanup
+// not to wait on it. A child can set errorNotifyPid to its parent so the
+// parent is interrupted too, rather than signalling the whole process group,
+// which may hold other runs.
+
+#include <pthread.h>
+#include <sys/types.h>
 
 extern char * exeName;
-void perrorExit(char * msg);
+extern pid_t errorNotifyPid;
+extern void (* errorCleanUp)();
+void perrorExit(char * msg) __attribute__((noreturn));
+int anyThreadFailed();
+int threadFailed(pthread_t thread);
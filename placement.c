@@ -0,0 +1,288 @@
+// placement.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that place oss and its user
+// processes on cpus. oss may be pinned to one cpu with -O, and -A chooses
+// where children run relative to it: on its SMT siblings, its last level
+// cache or its NUMA node, in a given cpu list, or spread one per cpu. The
+// topology comes from sysfs and is appended to the metrics file, so a
+// latency result can be tied to the cpus that produced it.
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+#include "parameters.h"
+#include "perrorExit.h"
+#include "placement.h"
+
+#define CPU_PATH "/sys/devices/system/cpu/cpu%d/"
+
+// A list of cpus below CPU_SETSIZE needs at most four digits and a separator
+// for each cpu
+#define CPU_LIST_SZ (5 * CPU_SETSIZE + 1)
+
+static const char * policyNames[] = {
+	"any", "cpuset", "siblings", "llc", "node", "spread"
+};
+
+static cpu_set_t allowedCpus;	// Where oss could run before placement
+static cpu_set_t childCpus;	// Where children may run
+static int spreadCpus[CPU_SETSIZE]; // Cpus of childCpus in order, for spread
+static int numSpreadCpus = 0;
+static int ossCpu = -1;		// Cpu oss is pinned to, or -1
+
+// Returns the PlacementPolicy with the given name, or -1 if there is none
+int placementPolicy(const char * name){
+	int i;
+
+	for (i = 0; i < sizeof(policyNames) / sizeof(policyNames[0]); i++)
+		if (strcmp(name, policyNames[i]) == 0) return i;
+
+	return -1;
+}
+
+// Sets set to the cpus in a list like "0-3,8", returning 0 if it is invalid
+static int parseCpuList(const char * list, cpu_set_t * set){
+	char * end;
+	long first, last;
+
+	CPU_ZERO(set);
+
+	while (*list != '\0' && *list != '\n'){
+		first = last = strtol(list, &end, 10);
+		if (end == list) return 0;
+		if (*end == '-'){
+			list = end + 1;
+			last = strtol(list, &end, 10);
+			if (end == list) return 0;
+		}
+		if (first < 0 || last < first || last >= CPU_SETSIZE)
+			return 0;
+
+		for (; first <= last; first++) CPU_SET(first, set);
+
+		list = end;
+		if (*list == ',') list++;
+	}
+
+	return CPU_COUNT(set) > 0;
+}
+
+// Writes the cpus in set to buffer as a list like "0-3,8"
+static void formatCpuList(const cpu_set_t * set, char * buffer, int size){
+	int cpu, last, length = 0;
+
+	buffer[0] = '\0';
+
+	for (cpu = 0; cpu < CPU_SETSIZE && length < size; cpu++){
+		if (!CPU_ISSET(cpu, set)) continue;
+
+		for (last = cpu; last + 1 < CPU_SETSIZE
+		     && CPU_ISSET(last + 1, set); last++);
+
+		length += snprintf(buffer + length, size - length,
+				   last > cpu ? "%s%d-%d" : "%s%d",
+				   length > 0 ? "," : "", cpu, last);
+		cpu = last;
+	}
+}
+
+// Reads a sysfs file of cpu into buffer, returning 0 if it can't be read
+static int readCpuFile(int cpu, const char * name, char * buffer, int size){
+	char path[BUFF_SZ];
+	FILE * fp;
+
+	snprintf(path, sizeof(path), CPU_PATH "%s", cpu, name);
+	if ((fp = fopen(path, "r")) == NULL) return 0;
+
+	if (fgets(buffer, size, fp) == NULL) buffer[0] = '\0';
+
+	// Treats a line too long for buffer as unreadable, not as a shorter one
+	if (strchr(buffer, '\n') == NULL && fgetc(fp) != EOF)
+		buffer[0] = '\0';
+	buffer[strcspn(buffer, "\n")] = '\0';
+	fclose(fp);
+
+	return buffer[0] != '\0';
+}
+
+// Reads the list of cpus sharing the highest level cache of cpu
+static int readLlcList(int cpu, char * buffer, int size){
+	char name[BUFF_SZ];
+	int index;
+
+	// Caches are listed from the lowest level up
+	for (index = 15; index >= 0; index--){
+		snprintf(name, sizeof(name), "cache/index%d/shared_cpu_list",
+			 index);
+		if (readCpuFile(cpu, name, buffer, size)) return 1;
+	}
+
+	return 0;
+}
+
+// Returns the NUMA node of cpu, or -1 if there is no node information
+static int cpuNode(int cpu){
+	char path[BUFF_SZ];
+	struct dirent * entry;
+	DIR * dir;
+	int node = -1;
+
+	snprintf(path, sizeof(path), CPU_PATH, cpu);
+	if ((dir = opendir(path)) == NULL) return -1;
+
+	while ((entry = readdir(dir)) != NULL)
+		if (sscanf(entry->d_name, "node%d", &node) == 1) break;
+
+	closedir(dir);
+
+	return node;
+}
+
+// Reads the cpus of the NUMA node of cpu, falling back to every cpu
+static int readNodeList(int cpu, char * buffer, int size){
+	char path[BUFF_SZ];
+	FILE * fp;
+	int node = cpuNode(cpu);
+
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+		 node);
+	if (node == -1 || (fp = fopen(path, "r")) == NULL){
+		snprintf(buffer, size, "0-%d", CPU_SETSIZE - 1);
+		return 1;
+	}
+
+	if (fgets(buffer, size, fp) == NULL) buffer[0] = '\0';
+	if (strchr(buffer, '\n') == NULL && fgetc(fp) != EOF)
+		buffer[0] = '\0';
+	fclose(fp);
+
+	return buffer[0] != '\0';
+}
+
+// Exits with a message about the -A or -O option
+static void placementError(char * message){
+	errno = EINVAL;
+	perrorExit(message);
+}
+
+// Pins oss and works out where its children run, from the -O and -A options
+void applyPlacement(){
+	char list[CPU_LIST_SZ];
+	const char * cpus = list;	// Cpus the policy names, if not all
+	cpu_set_t set;
+	int cpu, found = 1;
+
+	if (sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) == -1)
+		perrorExit("placement.c - failed to get cpu affinity");
+
+	// Policies relative to oss pin it where it is if -O wasn't given
+	ossCpu = params.ossCpu;
+	if (ossCpu == -1 && (params.placement == PLACE_SIBLINGS
+			     || params.placement == PLACE_LLC
+			     || params.placement == PLACE_NODE))
+		ossCpu = sched_getcpu();
+
+	if (ossCpu != -1){
+		if (ossCpu >= CPU_SETSIZE || !CPU_ISSET(ossCpu, &allowedCpus))
+			placementError("placement.c - cpu of -O not available");
+
+		CPU_ZERO(&set);
+		CPU_SET(ossCpu, &set);
+		if (sched_setaffinity(0, sizeof(set), &set) == -1)
+			perrorExit("placement.c - failed to pin oss");
+	}
+
+	// Reads the cpus the policy names
+	switch (params.placement){
+	case PLACE_SIBLINGS:
+		found = readCpuFile(ossCpu, "topology/thread_siblings_list",
+				    list, sizeof(list));
+		break;
+	case PLACE_LLC:
+		found = readLlcList(ossCpu, list, sizeof(list));
+		break;
+	case PLACE_NODE:
+		found = readNodeList(ossCpu, list, sizeof(list));
+		break;
+	default:
+		cpus = params.placementCpus;
+	}
+	if (cpus == NULL)
+		childCpus = allowedCpus;
+	else if (!found || !parseCpuList(cpus, &childCpus))
+		placementError("placement.c - can't read cpus for -A");
+	CPU_AND(&childCpus, &childCpus, &allowedCpus);
+
+	// Keeps children off the cpu of oss unless it was asked for or is all
+	if (params.placement != PLACE_CPUSET && params.placement != PLACE_ANY
+	    && ossCpu != -1 && CPU_COUNT(&childCpus) > 1)
+		CPU_CLR(ossCpu, &childCpus);
+
+	if (CPU_COUNT(&childCpus) == 0)
+		placementError("placement.c - no usable cpus for -A");
+
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		if (CPU_ISSET(cpu, &childCpus))
+			spreadCpus[numSpreadCpus++] = cpu;
+}
+
+// Sets the affinity of a newly forked child, the launchNumber-th launched
+void placeChild(int launchNumber){
+	cpu_set_t set = childCpus;
+
+	if (params.placement == PLACE_SPREAD){
+		CPU_ZERO(&set);
+		CPU_SET(spreadCpus[launchNumber % numSpreadCpus], &set);
+	}
+
+	if (sched_setaffinity(0, sizeof(set), &set) == -1)
+		perrorExit("placement.c - failed to place user process");
+}
+
+// Prints the placement and the topology of each cpu it used
+void printPlacement(FILE * fp){
+	char list[CPU_LIST_SZ];
+	cpu_set_t used = childCpus;
+	int cpu;
+
+	fprintf(fp, "placement %s\n", policyNames[params.placement]);
+	fprintf(fp, "oss_cpu %d\n", ossCpu);
+	formatCpuList(&childCpus, list, sizeof(list));
+	fprintf(fp, "child_cpus %s\n", list);
+
+	if (ossCpu != -1) CPU_SET(ossCpu, &used);
+
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++){
+		if (!CPU_ISSET(cpu, &used)) continue;
+
+		fprintf(fp, "cpu %d", cpu);
+		if (readCpuFile(cpu, "topology/core_id", list, sizeof(list)))
+			fprintf(fp, " core %s", list);
+		if (readCpuFile(cpu, "topology/physical_package_id", list,
+				sizeof(list)))
+			fprintf(fp, " package %s", list);
+		fprintf(fp, " node %d", cpuNode(cpu));
+		if (readCpuFile(cpu, "topology/thread_siblings_list", list,
+				sizeof(list)))
+			fprintf(fp, " siblings %s", list);
+		if (readLlcList(cpu, list, sizeof(list)))
+			fprintf(fp, " llc %s", list);
+		fprintf(fp, "\n");
+	}
+}
+
+// Appends the placement to the file at path
+void writePlacement(const char * path){
+	FILE * fp;
+
+	if ((fp = fopen(path, "a")) == NULL)
+		perrorExit("placement.c - failed to open metrics file");
+
+	printPlacement(fp);
+	fclose(fp);
+}
@@ -0,0 +1,28 @@
+// placement.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the PlacementPolicy type and headers
+// for functions that pin oss and its user processes to cpus and record the
+// topology they ran on.
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <stdio.h>
+
+// Where user processes may run, relative to the cpu of oss
+typedef enum PlacementPolicy {
+	PLACE_ANY,	// Wherever oss could run before it was pinned
+	PLACE_CPUSET,	// Anywhere in a given list of cpus
+	PLACE_SIBLINGS,	// On SMT siblings of the cpu of oss
+	PLACE_LLC,	// On cpus sharing the last level cache of oss
+	PLACE_NODE,	// On cpus of the NUMA node of oss
+	PLACE_SPREAD	// Each on one cpu, taken in turn from a list
+} PlacementPolicy;
+
+int placementPolicy(const char * name);
+void applyPlacement();
+void placeChild(int launchNumber);
+void printPlacement(FILE * fp);
+void writePlacement(const char * path);
+
+#endif
@@ -0,0 +1,199 @@
+// profile.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that time the stages named in
+// profile.h and print a table of them at exit. Stages are timed with the
+// time stamp counter, which is read in a few cycles, and converted to
+// nanoseconds with a rate measured against CLOCK_MONOTONIC at startup. With
+// PROFILE_COUNTERS, cycles, instructions, cache misses and context switches
+// are counted with perf_event_open as one group, read with a single system
+// call at each end of a stage. Counters the kernel won't open are reported
+// as unavailable. Nothing here is compiled without PROFILE.
+
+#ifdef PROFILE
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+#include "constants.h"
+#include "profile.h"
+
+#define CALIBRATION_NS 20000000	// Time the counter rate is measured over
+
+typedef struct stageTotals {
+	unsigned long long calls;
+	unsigned long long ticks;	// Time stamp counter ticks
+	unsigned long long maxTicks;
+	unsigned long long counters[NUM_COUNTERS];
+} StageTotals;
+
+static const char * stageNames[NUM_STAGES] = {
+	"loop", "generate", "wake", "dispatch", "burst", "process", "parse",
+	"enqueue", "log", "events", "checkpoint"
+};
+
+static __thread StageTotals totals[NUM_STAGES]; // Of the calling thread
+static double ticksPerNs = 1;	// Rate of the time stamp counter
+
+#ifdef PROFILE_COUNTERS
+static const char * counterNames[NUM_COUNTERS] = {
+	"cycles", "instructions", "cache_misses", "switches"
+};
+static const struct { unsigned int type; unsigned long long config; }
+	counterEvents[NUM_COUNTERS] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES}
+};
+static int groupFd = -1;	// Leader of the counter group
+static int slots[NUM_COUNTERS];	// Position of each counter in a read, or -1
+static int numOpen = 0;		// Counters in the group
+#endif
+
+// Returns CLOCK_MONOTONIC in nanoseconds
+static unsigned long long monotonicNs(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * (unsigned long long) BILLION + now.tv_nsec;
+}
+
+#ifdef PROFILE_COUNTERS
+// Opens the counters this process may use as one group, leaving the others out
+static void openCounters(){
+	struct perf_event_attr attr;
+	int i, fd;
+
+	for (i = 0; i < NUM_COUNTERS; i++){
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = counterEvents[i].type;
+		attr.config = counterEvents[i].config;
+		attr.disabled = groupFd == -1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP;
+
+		slots[i] = -1;
+		fd = syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+		if (fd == -1) continue;
+
+		if (groupFd == -1) groupFd = fd;
+		slots[i] = numOpen++;
+	}
+
+	if (groupFd != -1){
+		ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+// Copies the current count of each open counter into counters
+static void readCounters(unsigned long long * counters){
+	unsigned long long values[NUM_COUNTERS + 1]; // Count, then values
+	int i;
+
+	if (groupFd == -1
+	    || read(groupFd, values, sizeof(values)) < (int) sizeof(*values))
+		return;
+
+	for (i = 0; i < NUM_COUNTERS; i++)
+		if (slots[i] != -1) counters[i] = values[1 + slots[i]];
+}
+#endif
+
+// Measures the rate of the time stamp counter and opens any counters
+void profileInit(){
+	unsigned long long startNs, startTsc, ns;
+
+	startNs = monotonicNs();
+	startTsc = __rdtsc();
+	while ((ns = monotonicNs() - startNs) < CALIBRATION_NS);
+	ticksPerNs = (double) (__rdtsc() - startTsc) / ns;
+
+#ifdef PROFILE_COUNTERS
+	openCounters();
+#endif
+}
+
+// Marks the start of a stage
+ProfileMark profileStart(ProfileStage stage){
+	ProfileMark mark;
+
+	mark.stage = stage;
+#ifdef PROFILE_COUNTERS
+	memset(mark.counters, 0, sizeof(mark.counters));
+	readCounters(mark.counters);
+#endif
+	mark.tsc = __rdtsc();
+
+	return mark;
+}
+
+// Adds the time and counts since mark to the totals of its stage
+void profileStop(ProfileMark * mark){
+	unsigned long long ticks = __rdtsc() - mark->tsc;
+	StageTotals * t = &totals[mark->stage];
+
+	t->calls++;
+	t->ticks += ticks;
+	if (ticks > t->maxTicks) t->maxTicks = ticks;
+
+#ifdef PROFILE_COUNTERS
+	unsigned long long now[NUM_COUNTERS];
+	int i;
+
+	memcpy(now, mark->counters, sizeof(now));
+	readCounters(now);
+	for (i = 0; i < NUM_COUNTERS; i++)
+		t->counters[i] += now[i] - mark->counters[i];
+#endif
+}
+
+// Prints the calls, time and counts per call of each stage that ran
+void profileReport(FILE * fp){
+	double loopNs = totals[STAGE_LOOP].ticks / ticksPerNs;
+	double ns;
+	int i;
+
+	fprintf(fp, "%-10s %10s %12s %10s %10s %7s", "stage", "calls",
+		"total_ms", "mean_ns", "max_ns", "loop_%");
+#ifdef PROFILE_COUNTERS
+	int c;
+
+	for (c = 0; c < NUM_COUNTERS; c++)
+		fprintf(fp, " %13s", slots[c] == -1 ? "unavailable"
+			: counterNames[c]);
+	fprintf(fp, " %5s", "ipc");
+#endif
+	fprintf(fp, "\n");
+
+	// Counters are printed per call, like the mean time
+	for (i = 0; i < NUM_STAGES; i++){
+		StageTotals * t = &totals[i];
+
+		if (t->calls == 0) continue;
+
+		ns = t->ticks / ticksPerNs;
+		fprintf(fp, "%-10s %10llu %12.3f %10.0f %10.0f %7.2f",
+			stageNames[i], t->calls, ns / MILLION, ns / t->calls,
+			t->maxTicks / ticksPerNs,
+			loopNs > 0 ? 100 * ns / loopNs : 0);
+#ifdef PROFILE_COUNTERS
+		for (c = 0; c < NUM_COUNTERS; c++)
+			fprintf(fp, " %13.1f",
+				(double) t->counters[c] / t->calls);
+		fprintf(fp, " %5.2f", t->counters[0] > 0
+			? (double) t->counters[1] / t->counters[0] : 0);
+#endif
+		fprintf(fp, "\n");
+	}
+}
+
+#endif
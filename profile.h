@@ -0,0 +1,66 @@
+// profile.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains macros that time the stages of the scheduling loop of
+// oss when it is built with make DEF=-DPROFILE, and hardware counters around
+// them as well with DEF="-DPROFILE -DPROFILE_COUNTERS". Otherwise the macros
+// expand to nothing and the stages cost what they did before.
+//
+// PROFILE_SCOPE(stage) times the rest of the enclosing block, and
+// PROFILE_BEGIN(stage) and PROFILE_END(stage) time the statements between
+// them. A stage's time includes any stage run inside it.
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+
+typedef enum ProfileStage {
+	STAGE_LOOP,		// A whole iteration of the scheduling loop
+	STAGE_GENERATE,		// prepareArrival and generateProcess
+	STAGE_WAKE,		// checkBlockedProcesses
+	STAGE_DISPATCH,		// dispatchProcess
+	STAGE_BURST,		// waitForReply or simulateInProcess
+	STAGE_PROCESS,		// processMessage
+	STAGE_PARSE,		// parseMessage
+	STAGE_ENQUEUE,		// mEnqueue
+	STAGE_LOG,		// Writing a line to the log
+	STAGE_EVENTS,		// pollEvents
+	STAGE_CHECKPOINT,	// takeCheckpoint
+	NUM_STAGES
+} ProfileStage;
+
+#define NUM_COUNTERS 4	// Cycles, instructions, cache misses, switches
+
+// A stage's start, kept until it ends
+typedef struct profileMark {
+	ProfileStage stage;
+	unsigned long long tsc;
+	unsigned long long counters[NUM_COUNTERS];
+} ProfileMark;
+
+#ifdef PROFILE
+
+void profileInit();
+ProfileMark profileStart(ProfileStage stage);
+void profileStop(ProfileMark * mark);
+void profileReport(FILE * fp);
+
+#define PROFILE_INIT() profileInit()
+#define PROFILE_SCOPE(stage) ProfileMark profileScope \
+	__attribute__((cleanup(profileStop))) = profileStart(stage)
+#define PROFILE_BEGIN(stage) ProfileMark profileMark##stage = \
+	profileStart(stage)
+#define PROFILE_END(stage) profileStop(&profileMark##stage)
+#define PROFILE_REPORT(fp) profileReport(fp)
+
+#else
+
+#define PROFILE_INIT()
+#define PROFILE_SCOPE(stage)
+#define PROFILE_BEGIN(stage)
+#define PROFILE_END(stage)
+#define PROFILE_REPORT(fp)
+
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+// quantum.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that choose the time quantum
+// of each dispatch. By default a level's quantum is the base quantum halved
+// once per level. With -Q p, oss keeps a streaming estimate of the p-th
+// percentile of burst lengths for each level and class, and every
+// QUANTUM_RETUNE_BURSTS bursts sets the quanta to the estimates, so that
+// about a fraction p of bursts end before their quantum does.
+//
+// Each estimate moves up by a factor of 1 + QUANTUM_GAIN * p when a burst is
+// longer than it and down by 1 - QUANTUM_GAIN * (1 - p) otherwise, which
+// settles where a fraction p of bursts are shorter. A burst that used its
+// whole quantum was cut short, so it only shows that the burst was at least
+// that long and always counts as longer.
+
+#include "parameters.h"
+#include "quantum.h"
+
+static Quanta qs;	// Estimates and quanta of the current run
+
+// Returns the quantum of level in the fixed scheme
+static unsigned int fixedQuantum(int level){
+	return params.baseQuantum >> level;
+}
+
+// Sets every quantum and estimate to the fixed scheme's quantum
+void initializeQuanta(){
+	int class, level;
+
+	for (class = 0; class < NUM_CLASSES; class++){
+		for (level = 0; level < params.numQueueLevels; level++){
+			qs.estimates[class][level] = fixedQuantum(level);
+			qs.quanta[class][level] = fixedQuantum(level);
+		}
+	}
+
+	qs.burstsSinceRetune = 0;
+}
+
+// Returns the quantum given to a process of schedulingClass at level
+unsigned int levelQuantum(SchedulingClass schedulingClass, int level){
+	return qs.quanta[schedulingClass][level];
+}
+
+// Sets each quantum to its estimate, kept within QUANTUM_RANGE of the fixed one
+static void retune(){
+	double low, high, estimate;
+	int class, level;
+
+	for (class = 0; class < NUM_CLASSES; class++){
+		for (level = 0; level < params.numQueueLevels; level++){
+			low = (double) fixedQuantum(level) / QUANTUM_RANGE;
+			high = (double) fixedQuantum(level) * QUANTUM_RANGE;
+			estimate = qs.estimates[class][level];
+
+			if (estimate < low) estimate = low;
+			if (estimate > high) estimate = high;
+			qs.estimates[class][level] = estimate;
+			qs.quanta[class][level] = estimate < 1 ? 1 : estimate;
+		}
+	}
+
+	qs.burstsSinceRetune = 0;
+}
+
+// Updates the estimate of a burst's level and class, returning 1 on a retune
+int observeBurst(SchedulingClass schedulingClass, int level,
+		 unsigned int usedNano, int usedAll){
+	double * estimate = &qs.estimates[schedulingClass][level];
+	double p = params.quantumPercentile;
+
+	if (p == 0) return 0;
+
+	if (usedAll || usedNano > *estimate)
+		*estimate *= 1 + QUANTUM_GAIN * p;
+	else
+		*estimate *= 1 - QUANTUM_GAIN * (1 - p);
+
+	if (++qs.burstsSinceRetune < QUANTUM_RETUNE_BURSTS) return 0;
+
+	retune();
+	return 1;
+}
+
+// Copies the estimates and quanta, for checkpoints
+void saveQuanta(Quanta * saved){
+	*saved = qs;
+}
+
+// Replaces the estimates and quanta with ones saved earlier
+void restoreQuanta(const Quanta * saved){
+	qs = *saved;
+}
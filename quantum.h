@@ -0,0 +1,28 @@
+// quantum.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the Quanta type, which holds the time
+// quantum of each queue level and scheduling class, and headers for functions
+// that adapt the quanta to the burst lengths oss observes.
+
+#ifndef QUANTUM_H
+#define QUANTUM_H
+
+#include "constants.h"
+#include "pcb.h"
+
+#define NUM_CLASSES 2	// Scheduling classes, NORMAL and REAL_TIME
+
+typedef struct quanta {
+	double estimates[NUM_CLASSES][MAX_QUEUE_LEVELS]; // Burst percentiles
+	unsigned int quanta[NUM_CLASSES][MAX_QUEUE_LEVELS]; // Given at dispatch
+	int burstsSinceRetune;		// Bursts observed since the last retune
+} Quanta;
+
+void initializeQuanta();
+unsigned int levelQuantum(SchedulingClass schedulingClass, int level);
+int observeBurst(SchedulingClass schedulingClass, int level,
+		 unsigned int usedNano, int usedAll);
+void saveQuanta(Quanta * saved);
+void restoreQuanta(const Quanta * saved);
+
+#endif
@@ -1,6 +1,10 @@
 // queue.c was created by Mark Renard on 2/5/2020 and modified on 3/26/2020.
 // This file defines functions that operate on a queue of process control
 // blocks.
+//
+// Queues store pcb handles in a circular array of QUEUE_CAPACITY slots, a power
+// of two so positions wrap with a mask. Adding to either end and removing
+// from the front are O(1), and walking a queue reads consecutive slots.
 
 #include <stdlib.h>
 #include <string.h>
@@ -8,31 +12,50 @@
 #include "perrorExit.h"
 #include <stdio.h>
 
+#define MASK (QUEUE_CAPACITY - 1)
+
+_Static_assert((QUEUE_CAPACITY & MASK) == 0 && QUEUE_CAPACITY >= MAX_BLOCKS,
+	       "QUEUE_CAPACITY must be a power of two of at least MAX_BLOCKS");
+
 void initializeQueue(Queue * qPtr){
-	qPtr->front = NULL;
-	qPtr->back = NULL;
+	qPtr->front = 0;
 	qPtr->count = 0;
 }
 
+// Returns the process control block at a position counted from the front
+ProcessControlBlock * queueAt(const Queue * q, int position){
+	ProcessControlBlock * pcb;
+
+	if ((pcb = pcbFromHandle(q->slots[(q->front + position) & MASK]))
+	    == NULL)
+		perrorExit("Queue holds a process whose lifetime is over");
+
+	return pcb;
+}
+
+// Returns the process control block at the front, or NULL if empty
+ProcessControlBlock * queueFront(const Queue * q){
+	return q->count > 0 ? queueAt(q, 0) : NULL;
+}
+
 // Prints the simPid of process control blocks in the queue from front to back
 void printQueue(FILE * fp, const Queue * q){
-	ProcessControlBlock * pcb = q->front;
+	int i;
 
-	while (pcb != NULL){
-		fprintf(fp, " %02d", pcb->simPid);
-		pcb = pcb->previous;
-	}
+	for (i = 0; i < q->count; i++)
+		fprintf(fp, " %02d",
+			q->slots[(q->front + i) & MASK] & HANDLE_SIMPID_MASK);
 }
 
 // Adds a process control block to the front of the queue
 void addToFront(Queue * q, ProcessControlBlock * pcb){
-	pcb->previous = q->front;
-	q->front = pcb;
+	if (q->count >= QUEUE_CAPACITY)
+		perrorExit("Called addToFront on full queue");
 
-	// Adds to back as well if previously empty
-	if (q->back == NULL) q->back = pcb;
+	q->front = (q->front - 1) & MASK;
+	q->slots[q->front] = pcbHandle(pcb);
 	q->count++;
-	
+
 }
 
 // Adds a process control block to the back of the queue
@@ -42,51 +65,74 @@ void enqueue(Queue * q, ProcessControlBlock * pcb){
 	printQueue(stderr, q);
 	fprintf(stderr, " <- %02d\n", pcb->simPid);
 #endif
-	// Adds process control block to queue	
-	if (q->back != NULL){
-		// Adds to previous pcb of back if queue is not empty
-		q->back->previous = pcb;
-	} else {
-		// Adds to front if queue is empty
-		q->front = pcb;
-	}
-	q->back = pcb;
-
-	// Back of queue shouldn't have a previous element
-	q->back->previous = NULL;
+	if (q->count >= QUEUE_CAPACITY)
+		perrorExit("Called enqueue on full queue");
+
+	// Adds process control block to the slot after the back
+	q->slots[(q->front + q->count) & MASK] = pcbHandle(pcb);
 
 	// Increments node count in queue
 	q->count++;
 
 }
 
+// Inserts a process control block so that position blocks are ahead of it
+void insertInQueue(Queue * q, int position, ProcessControlBlock * pcb){
+	int i;
+
+	if (q->count >= QUEUE_CAPACITY)
+		perrorExit("Called insertInQueue on full queue");
+
+	// Shifts blocks behind the position back by one slot
+	for (i = q->count; i > position; i--)
+		q->slots[(q->front + i) & MASK] =
+			q->slots[(q->front + i - 1) & MASK];
+
+	q->slots[(q->front + position) & MASK] = pcbHandle(pcb);
+	q->count++;
+}
+
 // Removes and returns ProcessControlBlock reference from the front of the queue
 ProcessControlBlock * dequeue(Queue * q){
 
 	// Exits with an error message if queue is empty
-	if (q->count <= 0 || q->front == NULL || q->back == NULL)
+	if (q->count <= 0)
 		perrorExit("Called dequeue on empty queue");
 
 	// Assigns current front of queue to returnVal
-	ProcessControlBlock * returnVal = q->front;  	
-	
-	// Removes the front node from the queue
-	q->front = q->front->previous; // Assigns new front of queue
-	returnVal->previous = NULL; // Removes previous from dequeued block
-		
-	// Sets queue back to null if empty
-	if(q->front == NULL) q->back = NULL;
-	
+	ProcessControlBlock * returnVal = queueAt(q, 0);
+
+	// Removes the front slot from the queue
+	q->front = (q->front + 1) & MASK;
+	q->count--;
+
 #ifdef DEBUG_Q
 	fprintf(stderr, "\tdequeue(): %02d <-", returnVal->simPid);
 	printQueue(stderr, q);
 	fprintf(stderr, "\n");
 #endif
 
-	q->count--;
 	return returnVal;
 
 
 }
 
+// Removes and returns the process control block at a position from the front
+ProcessControlBlock * removeFromQueue(Queue * q, int position){
+	ProcessControlBlock * pcb;
+	int i;
 
+	if (position < 0 || position >= q->count)
+		perrorExit("Called removeFromQueue past the end of the queue");
+
+	pcb = queueAt(q, position);
+
+	// Shifts blocks behind the position forward by one slot
+	for (i = position; i < q->count - 1; i++)
+		q->slots[(q->front + i) & MASK] =
+			q->slots[(q->front + i + 1) & MASK];
+
+	q->count--;
+
+	return pcb;
+}
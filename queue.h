@@ -1,14 +1,19 @@
 // queue.h was created by Mark Renard on 2/5/2020
 // This file defines function prototypes for a string queue structure
+//
+// A Queue is a circular array of handles to the process control blocks in it
+// rather than a linked list, so it holds no pointers and can live in shared
+// memory where any process attached to it can read it.
 
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include "constants.h"
 #include "pcb.h" // Inlcudes definition of ProcessControlBlock
 
 typedef struct Queue {
-	ProcessControlBlock * back;
-	ProcessControlBlock * front;
+	unsigned int slots[QUEUE_CAPACITY]; // Handles, front at slots[front]
+	unsigned int front;		    // Index of the front slot
 	int count;
 } Queue;
 
@@ -16,7 +21,10 @@ void printQueue(FILE *, const Queue *);
 void addToFront(Queue * q, ProcessControlBlock * pcb);
 void initializeQueue(Queue *);
 void enqueue(Queue *, ProcessControlBlock *);
+void insertInQueue(Queue *, int position, ProcessControlBlock *);
 ProcessControlBlock * dequeue(Queue *);
+ProcessControlBlock * removeFromQueue(Queue *, int position);
+ProcessControlBlock * queueFront(const Queue *);
+ProcessControlBlock * queueAt(const Queue *, int position);
 
 #endif
-
@@ -0,0 +1,121 @@
+// queueTest.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a test of the functions in queue.c. Random additions to
+// either end, sorted insertions and removals from the front or middle are
+// applied both to a Queue and to a plain array, and the contents of the two
+// are compared after each.
+
+#include "constants.h"
+#include "pcb.h"
+#include "perrorExit.h"
+#include "queue.h"
+#include "randomGen.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define NUM_TESTS 100000
+
+static int compareContents(const Queue * q, const int model[], int count);
+
+int main(int argc, char * argv[]){
+	ProcessControlBlock blocks[MAX_BLOCKS];
+	int model[MAX_BLOCKS];		// simPids from front to back
+	int count = 0;			// simPids in model
+	int inQueue[MAX_BLOCKS] = {0};	// Nonzero if simPid is queued
+	unsigned int seed;
+	int i, j, simPid, position, mismatches = 0;
+	Queue q;
+
+	exeName = argv[0];
+
+	// Gets seed from argument vector or exits with an error message
+	if (argc < 2 || (seed = (unsigned int)atoi(argv[1])) == 0)
+		perrorExit("The first argument must be a non-zero seed");
+
+	seedRandom(seed);
+
+	for (i = 0; i < MAX_BLOCKS; i++)
+		blocks[i] = initialProcessControlBlock(i, 1, NORMAL);
+	setProcessTable(blocks, NULL);
+
+	initializeQueue(&q);
+
+	for (i = 0; i < NUM_TESTS; i++){
+
+		// Removes from the front or middle when full, and at random
+		// otherwise
+		if (count == MAX_BLOCKS || (count > 0 && randBinary(0.4))){
+			if (randBinary(0.5)){
+				position = 0;
+				simPid = dequeue(&q)->simPid;
+			} else {
+				position = randUnsigned(0, count - 1);
+				simPid = removeFromQueue(&q, position)->simPid;
+			}
+			if (simPid != model[position]){
+				printf("removal at %d returned %d, expected"
+				       " %d\n", position, simPid,
+				       model[position]);
+				mismatches++;
+			}
+			for (j = position + 1; j < count; j++)
+				model[j - 1] = model[j];
+			count--;
+			inQueue[simPid] = 0;
+
+		// Adds an unqueued simPid to the front, back or middle
+		} else {
+			do {
+				simPid = randUnsigned(0, MAX_BLOCKS - 1);
+			} while (inQueue[simPid]);
+			inQueue[simPid] = 1;
+
+			position = randUnsigned(0, 2);
+			if (position == 0){
+				addToFront(&q, &blocks[simPid]);
+			} else if (position == 1){
+				position = count;
+				enqueue(&q, &blocks[simPid]);
+			} else {
+				position = randUnsigned(0, count);
+				insertInQueue(&q, position, &blocks[simPid]);
+			}
+
+			for (j = count; j > position; j--)
+				model[j] = model[j - 1];
+			model[position] = simPid;
+			count++;
+		}
+
+		mismatches += compareContents(&q, model, count);
+	}
+
+	printf("%d operations, %d mismatches\n", NUM_TESTS, mismatches);
+
+	return mismatches > 0;
+}
+
+// Prints and returns 1 if the queue doesn't hold the model's simPids in order
+static int compareContents(const Queue * q, const int model[], int count){
+	int i;
+
+	if (q->count != count){
+		printf("count is %d, expected %d\n", q->count, count);
+		return 1;
+	}
+
+	for (i = 0; i < count; i++){
+		if (queueAt(q, i)->simPid != model[i]){
+			printf("MISMATCH at position %d:", i);
+			printQueue(stdout, q);
+			printf("\n");
+			return 1;
+		}
+	}
+
+	if (count > 0 && queueFront(q)->simPid != model[0]) return 1;
+	if (count == 0 && queueFront(q) != NULL) return 1;
+
+	return 0;
+}
@@ -1,7 +1,12 @@
 // randomGen.c was created by Mark Renard on 3/26/2020
 //
 // This file contains functions for generating random numbers of various types.
-// These should be used in a program where srand was called at some point.
+// These should be used in a program where seedRandom was called at some
+// point.
+//
+// Raw numbers come from splitmix64 rather than rand, whose state is hidden in
+// the C library, and are reduced to the range of rand so the functions below
+// behave as they did when they used it.
 //
 // randUnsigned inpired by:
 // https://bytes.com/topic/c/answers/135812-random-number-if-range-greater-than-rand_max
@@ -9,22 +14,59 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include "randomGen.h"
+
 #define RAND_DOUBLE_PRECISION 1000.0
+#define RAW_MAX 0x7fffffffU		// Largest raw number, as RAND_MAX
+
+static RandomGenerator defaultGenerator = {1};
+static RandomGenerator * generator = &defaultGenerator; // Used by rawRandom
+
+// Seeds a generator
+void seedRandomGenerator(RandomGenerator * gen, unsigned int seed){
+	gen->state = seed;
+}
+
+// Selects the generator used by the functions below
+void useRandomGenerator(RandomGenerator * gen){
+	generator = gen;
+}
+
+// Returns the generator used by the functions below
+RandomGenerator * currentRandomGenerator(){
+	return generator;
+}
+
+// Seeds the generator used by the functions below
+void seedRandom(unsigned int seed){
+	seedRandomGenerator(generator, seed);
+}
+
+// Returns a number in [0, RAW_MAX] and advances the current generator
+static unsigned int nextRaw(){
+	unsigned long long z = (generator->state += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	z = z ^ (z >> 31);
+
+	return (unsigned int) (z >> 33);
+}
 
-// Random int in range overlaping with [0, (RAND_MAX + 1) * RAND_MAX + RAND_MAX]
+// Random int in range overlaping with [0, (RAW_MAX + 1) * RAW_MAX + RAW_MAX]
 unsigned int randUnsigned(unsigned int min, unsigned int max){
-	unsigned int rawRandom;	// Biased raw output from rand
+	unsigned int rawRandom;	// Biased raw output from nextRaw
 
 	// The number of possible return values
 	unsigned int rangeSize = max - min + 1;
 
-	// The maximum value output by (RANDMAX + 1) * rand() + rand()
+	// The maximum value output by (RAW_MAX + 1) * nextRaw() + nextRaw()
 	unsigned int maxRawRandom = \
-		((unsigned int)RAND_MAX + 1) * RAND_MAX + RAND_MAX;
+		(RAW_MAX + 1) * RAW_MAX + RAW_MAX;
 
 	// Throws out overrepresented values to de-bias PRNG
 	do {
-		rawRandom = ((unsigned int)RAND_MAX + 1) * rand() + rand();
+		rawRandom = (RAW_MAX + 1) * nextRaw() + nextRaw();
 	} while (rawRandom > maxRawRandom - maxRawRandom % rangeSize);
 
 	return rawRandom % rangeSize + min;
@@ -32,9 +74,9 @@ unsigned int randUnsigned(unsigned int min, unsigned int max){
 
 // Returns a 1 with specified probability, 0 otherwise
 int randBinary(double probability){
-	int threshold = (int)(RAND_MAX * probability);
+	unsigned int threshold = (unsigned int)(RAW_MAX * probability);
 
-	return rand() < threshold ? 1 : 0;
+	return nextRaw() < threshold ? 1 : 0;
 }
 /*
 // Returns a double in range [min, max];
@@ -1,11 +1,23 @@
 // randomGen.h was created by Mark Renard on 3/26/2020
 //
 // This file contains prototypes for functions related to random number
-// generation, which should be called after srand has been called.
+// generation, which should be called after seedRandom has been called.
+//
+// Numbers come from the RandomGenerator selected with useRandomGenerator, or
+// a default one. Its state is a single word that can be copied, so a
+// simulation that keeps one per process can save and restore all of them.
 
 #ifndef RANDOMGEN_H
 #define RANDOMGEN_H
 
+typedef struct randomGenerator {
+	unsigned long long state;
+} RandomGenerator;
+
+void seedRandomGenerator(RandomGenerator * gen, unsigned int seed);
+void useRandomGenerator(RandomGenerator * gen);
+RandomGenerator * currentRandomGenerator();
+void seedRandom(unsigned int seed);
 unsigned int randUnsigned(unsigned int min, unsigned int max);
 int randBinary(double probability);
 
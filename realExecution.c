@@ -0,0 +1,139 @@
+// realExecution.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that let oss act as a
+// user-space scheduler of processes running real workloads with -X.
+//
+// Before each dispatch, oss makes the burst field of the process's block even
+// and arms a timer for the quantum. Timers on the cpu clocks of other
+// processes only fire on scheduler ticks, which are longer than the lower
+// quanta, so the timer runs on the monotonic clock instead. When its signal
+// arrives oss reads the process's cpu clock, and if time spent waiting or
+// descheduled leaves some of the quantum unused, rearms the timer for the
+// rest. Otherwise oss tries to make the burst field odd. If it does, the
+// process hasn't replied and never will, so oss stops it with SIGSTOP, makes
+// its reply a full quantum of the cpu time it measured and continues it with
+// SIGCONT at its next dispatch. A process that finishes first replies with
+// the thread cpu time it measured itself.
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#include "burst.h"
+#include "constants.h"
+#include "perrorExit.h"
+#include "realExecution.h"
+#include "workload.h"
+
+static timer_t timer;			// Quantum timer of the current burst
+static int timerArmed = 0;		// Nonzero until endRealBurst
+static unsigned int bursts = 0;		// Bursts begun, identifying timers
+static pid_t runningPid;		// Real pid of the process running
+static clockid_t runningClock;		// Cpu clock of the process running
+static unsigned long startNs;		// Its cpu time when the burst began
+static unsigned long quantumNs;		// Cpu time the burst may use
+static pid_t stopped[MAX_BLOCKS];	// Pid of each simPid stopped by oss
+
+// Returns the time of a cpu clock in nanoseconds
+static unsigned long cpuNs(clockid_t clock){
+	struct timespec now;
+
+	if (clock_gettime(clock, &now) == -1)
+		perrorExit("realExecution.c - failed to read cpu clock");
+
+	return now.tv_sec * (unsigned long) BILLION + now.tv_nsec;
+}
+
+// Arms the quantum timer to expire after ns nanoseconds
+static void armTimer(unsigned long ns){
+	struct itimerspec value = {{0, 0}, {ns / BILLION, ns % BILLION}};
+
+	if (timer_settime(timer, 0, &value, NULL) == -1)
+		perrorExit("realExecution.c - failed to set quantum timer");
+}
+
+// Watches for expired quanta and returns the spin loops per microsecond user
+// processes are given for their workloads
+unsigned long openRealExecution(){
+	memset(stopped, 0, sizeof(stopped));
+	watchQuantumSignal();
+
+	return calibrateWorkload();
+}
+
+// Numbers the burst of a process about to be dispatched, continues the
+// process if oss stopped it and starts its quantum timer
+void beginRealBurst(ProcessControlBlock * pcb, pid_t pid,
+		    unsigned int quantum){
+	struct sigevent expiry;
+
+	__atomic_store_n(&pcb->burst, (pcb->burst | 1) + 1, __ATOMIC_RELEASE);
+
+	// Measures the burst on the cpu clock of the process
+	if ((errno = clock_getcpuclockid(pid, &runningClock)) != 0)
+		perrorExit("realExecution.c - failed to get cpu clock");
+	runningPid = pid;
+	startNs = cpuNs(runningClock);
+	quantumNs = quantum;
+
+	memset(&expiry, 0, sizeof(expiry));
+	expiry.sigev_notify = SIGEV_SIGNAL;
+	expiry.sigev_signo = QUANTUM_SIGNAL;
+	expiry.sigev_value.sival_int = ++bursts;
+	if (timer_create(CLOCK_MONOTONIC, &expiry, &timer) == -1)
+		perrorExit("realExecution.c - failed to create quantum timer");
+	timerArmed = 1;
+	armTimer(quantumNs);
+
+	// Lets a process stopped at the end of its last quantum run again
+	if (stopped[pcb->simPid] == pid){
+		stopped[pcb->simPid] = 0;
+		kill(pid, SIGCONT);
+	}
+}
+
+// Ends the running burst if event is the expiry of its quantum and the
+// process hasn't replied, stopping the process and writing its reply to
+// msgText. Returns nonzero if it did.
+int expireRealBurst(const Event * event, ProcessControlBlock * pcb,
+		    char * msgText){
+	unsigned int burst = __atomic_load_n(&pcb->burst, __ATOMIC_ACQUIRE);
+	unsigned long used;
+	siginfo_t info;
+
+	// Ignores the timers of bursts that have already ended
+	if (event->type != QUANTUM_EVENT || event->burst != bursts
+	    || (burst & 1))
+		return 0;
+
+	// Gives the process the rest of a quantum it hasn't used yet
+	if ((used = cpuNs(runningClock) - startNs) < quantumNs){
+		armTimer(quantumNs - used);
+		return 0;
+	}
+
+	if (!__atomic_compare_exchange_n(&pcb->burst, &burst, burst + 1, 0,
+					 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return 0;
+
+	// Measures the cpu time used once the process has stopped
+	kill(runningPid, SIGSTOP);
+	if (waitid(P_PID, runningPid, &info, WSTOPPED) == -1)
+		perrorExit("realExecution.c - failed to wait for a stop");
+	stopped[pcb->simPid] = runningPid;
+
+	createReplyMessage(msgText, USES_ALL_QUANTUM_CH,
+			   cpuNs(runningClock) - startNs, -1, -1, -1);
+
+	return 1;
+}
+
+// Deletes the quantum timer of the burst that just ended
+void endRealBurst(){
+	if (!timerArmed) return;
+
+	timer_delete(timer);
+	timerArmed = 0;
+}
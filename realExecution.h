@@ -0,0 +1,22 @@
+// realExecution.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions oss uses to schedule user
+// processes that run their bursts for real with -X, enforcing each quantum
+// of cpu time with a timer.
+
+#ifndef REALEXECUTION_H
+#define REALEXECUTION_H
+
+#include <sys/types.h>
+
+#include "eventLoop.h"
+#include "pcb.h"
+
+unsigned long openRealExecution();
+void beginRealBurst(ProcessControlBlock * pcb, pid_t pid,
+		    unsigned int quantum);
+int expireRealBurst(const Event * event, ProcessControlBlock * pcb,
+		    char * msgText);
+void endRealBurst();
+
+#endif
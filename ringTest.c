@@ -0,0 +1,162 @@
+// ringTest.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a stress test of the completion ring in completionRing.c
+// and a comparison of its throughput with a SysV message queue. Producer
+// processes each send a numbered run of replies, first through a ring in
+// shared memory and then through a message queue, while the parent drains
+// them and checks that every producer's replies arrive once and in order.
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/msg.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "completionRing.h"
+#include "constants.h"
+#include "message.h"
+#include "perrorExit.h"
+#include "seqlock.h"
+
+#define DEFAULT_PRODUCERS 16
+#define DEFAULT_REPLIES 20000
+#define MAX_PRODUCERS 256
+
+typedef struct shared {
+	volatile int go;	// Set when producers may start
+	CompletionRing ring;
+} Shared;
+
+static long run(int useRing);
+static void produce(int useRing, int producer);
+static long nanoseconds();
+
+static int numProducers = DEFAULT_PRODUCERS;
+static int numReplies = DEFAULT_REPLIES;	// Replies per producer
+static Shared * shared;
+static int msgQueueId;
+
+int main(int argc, char * argv[]){
+	long mismatches = 0, start, elapsed;
+	int opt, useRing;
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "p:n:")) != -1){
+		if (opt == 'p') numProducers = atoi(optarg);
+		else if (opt == 'n') numReplies = atoi(optarg);
+		else {
+			fprintf(stderr, "Usage: %s [-p producers] [-n replies"
+				" per producer]\n", exeName);
+			exit(1);
+		}
+	}
+	if (numProducers < 1 || numProducers > MAX_PRODUCERS
+	    || numReplies < 1){
+		fprintf(stderr, "%s: need 1 to %d producers and at least one"
+			" reply\n", exeName, MAX_PRODUCERS);
+		exit(1);
+	}
+
+	shared = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED)
+		perrorExit("Failed to map shared memory");
+	msgQueueId = getMessageQueue(IPC_PRIVATE, MQ_PERMS | IPC_CREAT);
+
+	// Runs the ring first, then the message queue
+	for (useRing = 1; useRing >= 0; useRing--){
+		start = nanoseconds();
+		mismatches += run(useRing);
+		elapsed = nanoseconds() - start;
+
+		printf("%-5s %d producers x %d replies: %9.0f replies/s\n",
+		       useRing ? "ring" : "sysv", numProducers, numReplies,
+		       (double) numProducers * numReplies * BILLION / elapsed);
+	}
+
+	removeMessageQueue(msgQueueId);
+	printf("%ld mismatches\n", mismatches);
+
+	return mismatches > 0;
+}
+
+// Forks the producers and drains their replies, returning the mismatches
+static long run(int useRing){
+	Completion batch[COMPLETION_RING_SIZE];
+	int expected[MAX_PRODUCERS] = {0}; // Next reply of each producer
+	long received = 0, total = (long) numProducers * numReplies;
+	long mismatches = 0;
+	int i, count, producer, number;
+	pid_t pid;
+
+	initializeCompletionRing(&shared->ring);
+	shared->go = 0;
+
+	for (i = 0; i < numProducers; i++){
+		if ((pid = fork()) == -1) perrorExit("Failed to fork");
+		if (pid == 0) produce(useRing, i);
+	}
+	__atomic_store_n(&shared->go, 1, __ATOMIC_RELEASE);
+
+	while (received < total){
+
+		// Takes a batch from the ring, or one message from the queue
+		if (useRing){
+			count = waitForCompletions(&shared->ring, batch,
+						   COMPLETION_RING_SIZE, -1);
+		} else {
+			batch[0].simPid = -1;
+			waitForMessage(msgQueueId, batch[0].msgText, 0);
+			count = 1;
+		}
+
+		for (i = 0; i < count; i++){
+			sscanf(batch[i].msgText, "%d %d", &producer, &number);
+			if (producer < 0 || producer >= numProducers
+			    || number != expected[producer]){
+				mismatches++;
+				continue;
+			}
+			expected[producer]++;
+		}
+		received += count;
+	}
+
+	while (wait(NULL) > 0);
+
+	return mismatches;
+}
+
+// Sends a numbered run of replies and exits
+static void produce(int useRing, int producer){
+	Completion reply;
+	int i;
+
+	while (!__atomic_load_n(&shared->go, __ATOMIC_ACQUIRE)) sched_yield();
+
+	reply.simPid = producer;
+	for (i = 0; i < numReplies; i++){
+		sprintf(reply.msgText, "%d %d", producer, i);
+
+		if (useRing)
+			publishCompletion(&shared->ring, &reply);
+		else
+			sendMessage(msgQueueId, reply.msgText, producer + 1);
+	}
+
+	_exit(0);
+}
+
+// Returns a monotonic time in nanoseconds
+static long nanoseconds(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * BILLION + now.tv_nsec;
+}
@@ -0,0 +1,56 @@
+// seqlock.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains a sequence lock for data in shared memory that has a
+// single writer. The writer never waits. Readers copy the data between
+// seqlockReadBegin and seqlockReadRetry and try again if a write overlapped
+// the copy, so they never block the writer or each other.
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+// Hints to the cpu that the caller is spinning
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX() do {} while (0)
+#endif
+
+typedef struct seqlock {
+	unsigned int sequence;	// Odd while a write is in progress
+} Seqlock;
+
+// Initializes the lock with no write in progress
+static inline void seqlockInit(Seqlock * lock){
+	__atomic_store_n(&lock->sequence, 0, __ATOMIC_RELAXED);
+}
+
+// Marks the start of a write
+static inline void seqlockWriteBegin(Seqlock * lock){
+	unsigned int s = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+	__atomic_store_n(&lock->sequence, s + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// Marks the end of a write, publishing the data
+static inline void seqlockWriteEnd(Seqlock * lock){
+	unsigned int s = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+	__atomic_store_n(&lock->sequence, s + 1, __ATOMIC_RELEASE);
+}
+
+// Waits out a write in progress and returns the sequence to check against
+static inline unsigned int seqlockReadBegin(const Seqlock * lock){
+	unsigned int s;
+
+	while ((s = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE)) & 1U)
+		CPU_RELAX();
+
+	return s;
+}
+
+// Returns nonzero if the data read since seqlockReadBegin may be torn
+static inline int seqlockReadRetry(const Seqlock * lock, unsigned int start){
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != start;
+}
+
+#endif
@@ -0,0 +1,52 @@
+// sharedClock.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the SharedClock type, the simulated
+// system clock as oss publishes it in shared memory, and inline functions to
+// publish and read it. oss is the only writer. A reader copies both words of
+// the clock under a seqlock and tries again if oss published meanwhile, so a
+// user process gets a consistent time with a few loads, never a lock or a
+// system call, and never delays oss.
+
+#ifndef SHAREDCLOCK_H
+#define SHAREDCLOCK_H
+
+#include "clock.h"
+#include "seqlock.h"
+
+typedef struct sharedClock {
+	Seqlock lock;
+	Clock time;		// Written only between seqlock writes
+} SharedClock;
+
+// Sets the clock to time with no write in progress, before readers attach
+static inline void initializeSharedClock(SharedClock * clock, Clock time){
+	seqlockInit(&clock->lock);
+	clock->time = time;
+}
+
+// Publishes time to readers of the clock
+static inline void publishClock(SharedClock * clock, Clock time){
+	seqlockWriteBegin(&clock->lock);
+	__atomic_store_n(&clock->time.seconds, time.seconds, __ATOMIC_RELAXED);
+	__atomic_store_n(&clock->time.nanoseconds, time.nanoseconds,
+			 __ATOMIC_RELAXED);
+	seqlockWriteEnd(&clock->lock);
+}
+
+// Returns the time last published, never a mix of two publications
+static inline Clock readSharedClock(const SharedClock * clock){
+	unsigned int start;
+	Clock time;
+
+	do {
+		start = seqlockReadBegin(&clock->lock);
+		time.seconds = __atomic_load_n(&clock->time.seconds,
+					       __ATOMIC_RELAXED);
+		time.nanoseconds = __atomic_load_n(&clock->time.nanoseconds,
+						   __ATOMIC_RELAXED);
+	} while (seqlockReadRetry(&clock->lock, start));
+
+	return time;
+}
+
+#endif
@@ -0,0 +1,128 @@
+// sharedClockTest.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a stress test of the SharedClock in sharedClock.h. The
+// parent publishes a run of times whose seconds and nanoseconds are always
+// equal while reader processes read the clock as fast as they can, counting
+// any time that mixes two publications or goes backwards.
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "perrorExit.h"
+#include "sharedClock.h"
+
+#define DEFAULT_READERS 4
+#define DEFAULT_PUBLICATIONS 10000000
+#define MAX_READERS 256
+
+typedef struct shared {
+	SharedClock clock;
+	volatile int go;		// Set when the writer starts
+	volatile int done;		// Set when the writer is finished
+	long torn[MAX_READERS];		// Inconsistent reads of each reader
+	long reads[MAX_READERS];	// Reads made by each reader
+} Shared;
+
+static void readClock(int reader);
+static long nanoseconds();
+
+static int numReaders = DEFAULT_READERS;
+static Shared * shared;
+
+int main(int argc, char * argv[]){
+	long publications = DEFAULT_PUBLICATIONS, torn = 0, reads = 0;
+	long start, elapsed, i;
+	Clock time;
+	int opt;
+	pid_t pid;
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "r:n:")) != -1){
+		if (opt == 'r') numReaders = atoi(optarg);
+		else if (opt == 'n') publications = atol(optarg);
+		else {
+			fprintf(stderr, "Usage: %s [-r readers] [-n "
+				"publications]\n", exeName);
+			exit(1);
+		}
+	}
+	if (numReaders < 1 || numReaders > MAX_READERS || publications < 1){
+		fprintf(stderr, "%s: need 1 to %d readers and at least one"
+			" publication\n", exeName, MAX_READERS);
+		exit(1);
+	}
+
+	shared = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED)
+		perrorExit("Failed to map shared memory");
+
+	time.seconds = time.nanoseconds = 0;
+	initializeSharedClock(&shared->clock, time);
+
+	for (i = 0; i < numReaders; i++){
+		if ((pid = fork()) == -1) perrorExit("Failed to fork");
+		if (pid == 0) readClock(i);
+	}
+
+	// Publishes times whose two words only agree if read together
+	start = nanoseconds();
+	__atomic_store_n(&shared->go, 1, __ATOMIC_RELEASE);
+	for (i = 1; i <= publications; i++){
+		time.seconds = time.nanoseconds = i;
+		publishClock(&shared->clock, time);
+	}
+	elapsed = nanoseconds() - start;
+	__atomic_store_n(&shared->done, 1, __ATOMIC_RELEASE);
+
+	while (wait(NULL) > 0);
+
+	for (i = 0; i < numReaders; i++){
+		torn += shared->torn[i];
+		reads += shared->reads[i];
+	}
+
+	printf("%ld publications: %9.0f publications/s\n", publications,
+	       (double) publications * BILLION / elapsed);
+	printf("%d readers: %ld reads, %ld torn\n", numReaders, reads, torn);
+
+	return torn > 0;
+}
+
+// Reads the clock until the writer is done, checking each time read
+static void readClock(int reader){
+	long torn = 0, reads = 0;
+	unsigned int last = 0;
+	Clock time;
+
+	while (!__atomic_load_n(&shared->go, __ATOMIC_ACQUIRE)) sched_yield();
+
+	while (!__atomic_load_n(&shared->done, __ATOMIC_ACQUIRE)){
+		time = readSharedClock(&shared->clock);
+		if (time.seconds != time.nanoseconds || time.seconds < last)
+			torn++;
+		last = time.seconds;
+		reads++;
+	}
+
+	shared->torn[reader] = torn;
+	shared->reads[reader] = reads;
+
+	_exit(0);
+}
+
+// Returns a monotonic time in nanoseconds
+static long nanoseconds(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * BILLION + now.tv_nsec;
+}
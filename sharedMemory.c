@@ -2,22 +2,38 @@
 //
 // This file contains an implementation of a function that returns a pointer
 // to a shared memory region of the requested size in bytes corresponding to
-// the key set in shmkey.h. If one does not exist and mask is set equal to
-// IPC_CREAT as defined in sys/ipc.h, one will be created.
+// the key passed in, which is derived from the key set in shmkey.h. If one
+// does not exist and mask is set equal to IPC_CREAT as defined in sys/ipc.h,
+// one will be created.
+//
+// A region can instead be a POSIX shared memory object or a memfd mapped with
+// mmap. Its pages are populated when mapped, so no process takes faults on
+// first touch, and children map it through an inherited file descriptor
+// rather than a key.
 
+#define _GNU_SOURCE
+#include <fcntl.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
+#include "constants.h"
 #include "perrorExit.h"
-#include "shmkey.h"
+#include "sharedMemory.h"
 
 static int shmid; // The shmid of the shared memory region
 
+// Set while a region is mapped with mmap rather than attached with shmat
+static int mappedFd = -1;		// Descriptor of the mapped object
+static size_t mappedSize = 0;		// Size of the mapping
+static const char * mappedName = NULL;	// Name of a POSIX object, if any
+
 // Returns a pointer to a new shared memory region
-char * sharedMemory(int size, int mask){
-	shmid = shmget ( SHMKEY, size, 0600 | mask );
+char * sharedMemory(int key, int size, int mask){
+	shmid = shmget ( key, size, 0600 | mask );
 
 	// Prints error message and exits if unsuccessful
 	if (shmid == -1)
@@ -27,13 +43,135 @@ char * sharedMemory(int size, int mask){
 	return shmat (shmid, 0, 0);
 }
 
+// Returns a read-only pointer to an existing region, or NULL if there is none
+char * sharedMemoryReadOnly(int key){
+	int id;
+	char * shm;
+
+	if ((id = shmget(key, 0, 0)) == -1)
+		return NULL;
+
+	if ((shm = shmat(id, 0, SHM_RDONLY)) == (char *) -1)
+		return NULL;
+
+	return shm;
+}
+
+// Maps an object with its pages populated, exiting on failure
+static char * mapPopulated(int fd, size_t size, int prot){
+	char * shm = mmap(NULL, size, prot, MAP_SHARED | MAP_POPULATE, fd, 0);
+
+	if (shm == MAP_FAILED)
+		perrorExit("sharedMemory.c - mmap failed");
+
+	mappedFd = fd;
+	mappedSize = size;
+
+	return shm;
+}
+
+// Creates a POSIX object named name, or a memfd if name is NULL, and maps it
+char * mappedSharedMemory(const char * name, int size, int options){
+	size_t mapSize = size;
+	int fd;
+
+	// Gets an object, clearing close-on-exec so children inherit it
+	if (name == NULL){
+		unsigned int flags = 0;
+
+		if (options & SHM_OPT_HUGE_PAGES){
+			flags |= MFD_HUGETLB;
+			mapSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE
+				  * HUGE_PAGE_SIZE;
+		}
+		fd = memfd_create("oss", flags);
+	} else {
+		fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+		if (fd != -1 && fcntl(fd, F_SETFD, 0) == -1) fd = -1;
+		mappedName = name;
+	}
+
+	if (fd == -1)
+		perrorExit("mappedSharedMemory failed to create object");
+
+	if (ftruncate(fd, mapSize) == -1)
+		perrorExit("mappedSharedMemory failed to size object");
+
+	char * shm = mapPopulated(fd, mapSize, PROT_READ | PROT_WRITE);
+
+	// Asks for transparent huge pages where hugetlb pages weren't used
+	if ((options & SHM_OPT_HUGE_PAGES) && name != NULL
+	    && madvise(shm, mapSize, MADV_HUGEPAGE) == -1)
+		perrorExit("mappedSharedMemory failed to request huge pages");
+
+	// Keeps the region resident
+	if ((options & SHM_OPT_LOCKED) && mlock(shm, mapSize) == -1)
+		perrorExit("mappedSharedMemory failed to lock pages");
+
+	return shm;
+}
+
+// Returns the descriptor of the mapped region, for children to inherit
+int sharedMemoryFd(){
+	return mappedFd;
+}
+
+// Maps the whole of a region through a descriptor inherited from oss
+char * attachSharedMemoryFd(int fd){
+	struct stat st;
+
+	if (fstat(fd, &st) == -1)
+		perrorExit("attachSharedMemoryFd failed to stat descriptor");
+
+	return mapPopulated(fd, st.st_size, PROT_READ | PROT_WRITE);
+}
+
+// Maps a POSIX object read-only, or returns NULL if there is none
+char * mappedSharedMemoryReadOnly(const char * name){
+	struct stat st;
+	char * shm;
+	int fd;
+
+	if ((fd = shm_open(name, O_RDONLY, 0)) == -1)
+		return NULL;
+
+	if (fstat(fd, &st) == -1 || st.st_size == 0){
+		close(fd);
+		return NULL;
+	}
+
+	shm = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (shm == MAP_FAILED){
+		close(fd);
+		return NULL;
+	}
+
+	mappedFd = fd;
+	mappedSize = st.st_size;
+
+	return shm;
+}
+
 // Detatches the process from shm or exits with error message on failure
 void detach(char * shm){
+	if (mappedSize > 0){
+		if (munmap(shm, mappedSize) == -1) perrorExit("Failed to unmap");
+		return;
+	}
+
 	if(shmdt(shm) == -1) perrorExit("Failed to detach");
 }
 
 // Removes a shared memory segment previously created with sharedMemory
 void removeSegment(){
+	if (mappedSize > 0){
+		if (mappedName != NULL && shm_unlink(mappedName) == -1)
+			perrorExit("removeSegment failed to unlink");
+		close(mappedFd);
+		mappedSize = 0;
+		return;
+	}
+
 	if (shmctl(shmid, IPC_RMID, NULL) == -1)
 		perrorExit("removeSegment failed");
 }
@@ -1,6 +1,7 @@
 // sharedMemory.h was created by Mark Renard on 2/21/2020
 // This file contains a headers for the functions sharedMemory and
-// removeSegment, which are defined in sharedMemory.c
+// removeSegment, which are defined in sharedMemory.c, and for functions that
+// map POSIX shared memory and memfd regions instead.
 
 #ifndef SHAREDMEMORY_H
 #define SHAREDMEMORY_H
@@ -8,7 +9,19 @@
 #include <sys/ipc.h>
 #include <sys/shm.h>
 
-char * sharedMemory(int size, int mask);
+// Where the shared memory region of oss lives
+typedef enum ShmBackend {SYSV_SHM, POSIX_SHM, MEMFD_SHM} ShmBackend;
+
+// Options of mappedSharedMemory
+#define SHM_OPT_HUGE_PAGES 1	// Backs the region with huge pages
+#define SHM_OPT_LOCKED 2		// Locks the region in memory
+
+char * sharedMemory(int key, int size, int mask);
+char * sharedMemoryReadOnly(int key);
+char * mappedSharedMemory(const char * name, int size, int options);
+int sharedMemoryFd();
+char * attachSharedMemoryFd(int fd);
+char * mappedSharedMemoryReadOnly(const char * name);
 void removeSegment();
 void detach(char * shm);
 void initializeSharedMemory(char * shm, int bufferSize, char byte);
@@ -0,0 +1,117 @@
+// sketch.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that count values in a Sketch
+// and read its quantiles, in the manner of DDSketch.
+//
+// Bucket i counts the values in (g^(i - 1), g^i], where g is
+// (1 + SKETCH_ACCURACY) / (1 - SKETCH_ACCURACY), so any value in a bucket is
+// within SKETCH_ACCURACY of 2g^i / (g + 1), the value a quantile falling in it
+// is given. Buckets are fixed rather than chosen by the values, so merging two
+// sketches adds their counts, and gives the sketch of all their values.
+//
+// A sketch is written as a line of its zeros and then bucket:count pairs of
+// its non-empty buckets, which readSketch reads back unchanged.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sketch.h"
+
+// Returns the logarithm of the bucket growth factor g
+static double logGrowth(){
+	static double logG = 0;
+
+	if (logG == 0)
+		logG = log((1 + SKETCH_ACCURACY) / (1 - SKETCH_ACCURACY));
+
+	return logG;
+}
+
+// Returns the bucket counting a value of ns nanoseconds, at least one
+static int sketchBucket(unsigned long long ns){
+	double index = ceil(log((double) ns) / logGrowth());
+
+	return index < SKETCH_BUCKETS - 1 ? (int) index : SKETCH_BUCKETS - 1;
+}
+
+// Returns the value given to quantiles falling in a bucket
+static unsigned long long sketchValue(int bucket){
+	double g = exp(logGrowth());
+
+	if (bucket == 0) return 1;
+
+	return (unsigned long long) llround(2 * pow(g, bucket) / (g + 1));
+}
+
+// Counts a value of ns nanoseconds
+void sketchAdd(Sketch * s, unsigned long long ns){
+	if (ns == 0)
+		s->zeros++;
+	else
+		s->counts[sketchBucket(ns)]++;
+	s->count++;
+}
+
+// Adds the values counted by from to into
+void sketchMerge(Sketch * into, const Sketch * from){
+	int i;
+
+	for (i = 0; i < SKETCH_BUCKETS; i++)
+		into->counts[i] += from->counts[i];
+	into->zeros += from->zeros;
+	into->count += from->count;
+}
+
+// Returns the q-th quantile of the values, or 0 if there were none
+unsigned long long sketchQuantile(const Sketch * s, double q){
+	unsigned long rank = (unsigned long) (q * s->count + 0.5);
+	unsigned long seen = s->zeros;
+	int i;
+
+	if (rank < 1) rank = 1;
+	if (s->count == 0 || seen >= rank) return 0;
+
+	for (i = 0; i < SKETCH_BUCKETS - 1; i++)
+		if ((seen += s->counts[i]) >= rank) break;
+
+	return sketchValue(i);
+}
+
+// Writes the zeros and non-empty buckets of a sketch, ending the line
+void writeSketch(FILE * fp, const Sketch * s){
+	int i;
+
+	fprintf(fp, " %lu", s->zeros);
+	for (i = 0; i < SKETCH_BUCKETS; i++)
+		if (s->counts[i] > 0)
+			fprintf(fp, " %d:%lu", i, s->counts[i]);
+	fprintf(fp, "\n");
+}
+
+// Fills a sketch from text written by writeSketch, returning 0 if it isn't
+int readSketch(const char * text, Sketch * s){
+	unsigned long count;
+	char * end;
+	long bucket;
+
+	memset(s, 0, sizeof(Sketch));
+
+	s->zeros = strtoul(text, &end, 10);
+	if (end == text) return 0;
+	s->count = s->zeros;
+
+	// Reads bucket:count pairs to the end of the line
+	while (*(text = end) == ' '){
+		bucket = strtol(text + 1, &end, 10);
+		if (*end != ':' || bucket < 0 || bucket >= SKETCH_BUCKETS)
+			return 0;
+		text = end + 1;
+		count = strtoul(text, &end, 10);
+		if (end == text) return 0;
+		s->counts[bucket] += count;
+		s->count += count;
+	}
+
+	return *text == '\n' || *text == '\0';
+}
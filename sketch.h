@@ -0,0 +1,29 @@
+// sketch.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the Sketch type, which counts
+// nanosecond values in a fixed amount of memory and returns their quantiles
+// within a relative accuracy, and headers for functions that use it. Sketches
+// of the same values merge exactly, whatever run or order they came from.
+
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <stdio.h>
+
+#define SKETCH_ACCURACY 0.02	// Relative accuracy of quantiles
+#define SKETCH_BUCKETS 1024	// Buckets, reaching past a year of nanoseconds
+#define SKETCH_FORMAT "osssketch 1"	// First line of a file of sketches
+
+typedef struct sketch {
+	unsigned long counts[SKETCH_BUCKETS];	// Values counted by bucket
+	unsigned long zeros;			// Values of zero
+	unsigned long count;			// Values counted
+} Sketch;
+
+void sketchAdd(Sketch * s, unsigned long long ns);
+void sketchMerge(Sketch * into, const Sketch * from);
+unsigned long long sketchQuantile(const Sketch * s, double q);
+void writeSketch(FILE * fp, const Sketch * s);
+int readSketch(const char * text, Sketch * s);
+
+#endif
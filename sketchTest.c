@@ -0,0 +1,103 @@
+// sketchTest.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a test of the sketches in sketch.c. Random values
+// spanning nanoseconds to hours are counted both in a sketch and in a sorted
+// array, and each quantile of the sketch must be within SKETCH_ACCURACY of the
+// value of the same rank. The values are also split among sketches at random,
+// and merging those, in either order, must give the sketch of all of them, as
+// must writing a sketch out and reading it back.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "randomGen.h"
+#include "sketch.h"
+
+#define NUM_VALUES 200000
+#define NUM_PARTS 4
+
+static unsigned long long values[NUM_VALUES];
+static Sketch whole, parts[NUM_PARTS], merged, reversed, read;
+
+// Orders values for qsort
+static int compareValues(const void * a, const void * b){
+	unsigned long long x = *(const unsigned long long *) a;
+	unsigned long long y = *(const unsigned long long *) b;
+
+	return (x > y) - (x < y);
+}
+
+// Returns a value whose number of digits is uniform, or 0 now and then
+static unsigned long long randomValue(){
+	unsigned long long value = randUnsigned(1, 9);
+	int digits = randUnsigned(0, 13);
+
+	if (randBinary(0.01)) return 0;
+
+	while (digits-- > 0)
+		value = value * 10 + randUnsigned(0, 9);
+
+	return value;
+}
+
+int main(int argc, char * argv[]){
+	static const double quantiles[] = {0.01, 0.1, 0.25, 0.5, 0.75, 0.9,
+					   0.99, 0.999};
+	unsigned long long exact, estimate;
+	long rank;
+	int i, failures = 0;
+	char text[SKETCH_BUCKETS * 32];
+	FILE * fp;
+
+	seedRandom(argc > 1 ? strtoul(argv[1], NULL, 10) : 1);
+
+	for (i = 0; i < NUM_VALUES; i++){
+		values[i] = randomValue();
+		sketchAdd(&whole, values[i]);
+		sketchAdd(&parts[randUnsigned(0, NUM_PARTS - 1)], values[i]);
+	}
+	qsort(values, NUM_VALUES, sizeof(values[0]), compareValues);
+
+	// Each quantile is within the accuracy of the value of its rank
+	for (i = 0; i < (int) (sizeof(quantiles) / sizeof(double)); i++){
+		rank = (long) (quantiles[i] * NUM_VALUES + 0.5);
+		exact = values[rank < 1 ? 0 : rank - 1];
+		estimate = sketchQuantile(&whole, quantiles[i]);
+		if (estimate < exact * (1 - SKETCH_ACCURACY) - 1
+		    || estimate > exact * (1 + SKETCH_ACCURACY) + 1){
+			printf("quantile %g: %llu, expected %llu\n",
+			       quantiles[i], estimate, exact);
+			failures++;
+		}
+	}
+
+	// Merging the parts in either order gives the whole
+	for (i = 0; i < NUM_PARTS; i++){
+		sketchMerge(&merged, &parts[i]);
+		sketchMerge(&reversed, &parts[NUM_PARTS - 1 - i]);
+	}
+	if (memcmp(&merged, &whole, sizeof(Sketch)) != 0
+	    || memcmp(&reversed, &whole, sizeof(Sketch)) != 0){
+		printf("merged sketches differ from the whole\n");
+		failures++;
+	}
+
+	// Writing a sketch and reading it back gives the same sketch
+	if ((fp = fmemopen(text, sizeof(text), "w")) == NULL){
+		perror("fmemopen");
+		return 1;
+	}
+	writeSketch(fp, &whole);
+	fclose(fp);
+	if (!readSketch(text, &read)
+	    || memcmp(&read, &whole, sizeof(Sketch)) != 0){
+		printf("sketch read back differs from the one written\n");
+		failures++;
+	}
+
+	printf("%d values, %zu bytes a sketch, %d failures\n", NUM_VALUES,
+	       sizeof(Sketch), failures);
+
+	return failures > 0;
+}
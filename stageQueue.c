@@ -0,0 +1,127 @@
+// stageQueue.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that pass elements from one
+// thread of oss to another through a StageQueue.
+//
+// head and tail count elements popped and pushed, wrapping freely, so the
+// queue is empty when they are equal and full when they differ by its
+// capacity. The producer copies an element into its slot before publishing
+// the new tail, and the consumer copies it out before publishing the new head.
+//
+// An empty queue's consumer announces that it is sleeping, checks the tail
+// once more and waits on the tail as a futex. The producer wakes it only if
+// it announced, so pushing costs no system call while the consumer keeps up.
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "perrorExit.h"
+#include "seqlock.h"
+#include "stageQueue.h"
+
+#define SPIN_LIMIT 100		// Spins before a full queue's producer yields
+
+// Allocates an empty queue of capacity elements, a power of two
+void createStageQueue(StageQueue * q, unsigned int capacity,
+		      size_t elementSize){
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+		perrorExit("stageQueue.c - capacity must be a power of two");
+
+	if ((q->elements = malloc(capacity * elementSize)) == NULL)
+		perrorExit("stageQueue.c - failed to allocate queue");
+
+	q->mask = capacity - 1;
+	q->elementSize = elementSize;
+	q->head = 0;
+	q->sleeping = 0;
+	__atomic_store_n(&q->tail, 0, __ATOMIC_RELEASE);
+}
+
+// Adds an element, waiting for the consumer if the queue is full
+void stagePush(StageQueue * q, const void * element){
+	unsigned int tail = q->tail;
+	int spins = 0;
+
+	while (tail - __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) > q->mask){
+		if (++spins < SPIN_LIMIT){
+			CPU_RELAX();
+		} else {
+			// Gives up on a consumer that may have stopped on an error
+			if (anyThreadFailed())
+				perrorExit("stageQueue.c - a thread failed");
+			sched_yield();
+			spins = 0;
+		}
+	}
+
+	memcpy(q->elements + (tail & q->mask) * q->elementSize, element,
+	       q->elementSize);
+	__atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+
+	// Orders the publication before the check, as the consumer does
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&q->sleeping, __ATOMIC_RELAXED))
+		syscall(SYS_futex, &q->tail, FUTEX_WAKE_PRIVATE, 1, NULL,
+			NULL, 0);
+}
+
+// Copies out and removes the oldest element, returning 0 if there is none
+int stageTryPop(StageQueue * q, void * element){
+	unsigned int head = q->head;
+
+	if (__atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == head)
+		return 0;
+
+	memcpy(element, q->elements + (head & q->mask) * q->elementSize,
+	       q->elementSize);
+	__atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+
+	return 1;
+}
+
+// Copies out and removes the oldest element, sleeping until there is one
+void stagePop(StageQueue * q, void * element){
+	unsigned int tail;
+
+	while (!stageTryPop(q, element)){
+
+		// Announces the sleep, then checks again before committing to it
+		tail = q->head;
+		__atomic_store_n(&q->sleeping, 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		// Returns at once if the tail moved since the queue was empty
+		if (__atomic_load_n(&q->tail, __ATOMIC_RELAXED) == tail
+		    && syscall(SYS_futex, &q->tail, FUTEX_WAIT_PRIVATE, tail,
+			       NULL, NULL, 0) == -1
+		    && errno != EAGAIN && errno != EINTR)
+			perrorExit("stageQueue.c - futex wait failed");
+
+		__atomic_store_n(&q->sleeping, 0, __ATOMIC_RELAXED);
+	}
+}
+
+// Frees the elements of a queue no thread uses any more
+void destroyStageQueue(StageQueue * q){
+	free(q->elements);
+	q->elements = NULL;
+}
+
+// Starts a thread running run with every signal blocked, leaving them to the
+// main thread
+void startStageThread(pthread_t * thread, void * (* run)(void *)){
+	sigset_t all, old;
+
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	if ((errno = pthread_create(thread, NULL, run, NULL)) != 0)
+		perrorExit("stageQueue.c - failed to start thread");
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
@@ -0,0 +1,41 @@
+// stageQueue.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the StageQueue type, a bounded
+// single-producer, single-consumer queue of fixed-size elements that passes
+// work between the threads of oss, and headers for functions that use it.
+// Neither end takes a lock: the producer waits only while the queue is full,
+// and the consumer sleeps on a futex only while it is empty.
+
+#ifndef STAGEQUEUE_H
+#define STAGEQUEUE_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "constants.h"
+
+typedef struct stageQueue {
+
+	// Only written by the producer
+	unsigned int tail __attribute__((aligned(CACHE_LINE_SIZE)));
+
+	// Only written by the consumer
+	unsigned int head __attribute__((aligned(CACHE_LINE_SIZE)));
+	unsigned int sleeping;		// Nonzero while the consumer sleeps
+
+	// Set when the queue is created
+	unsigned int mask __attribute__((aligned(CACHE_LINE_SIZE)));
+	size_t elementSize;
+	char * elements;		// mask + 1 elements of elementSize
+
+} StageQueue;
+
+void createStageQueue(StageQueue * q, unsigned int capacity,
+		      size_t elementSize);
+void stagePush(StageQueue * q, const void * element);
+void stagePop(StageQueue * q, void * element);
+int stageTryPop(StageQueue * q, void * element);
+void destroyStageQueue(StageQueue * q);
+void startStageThread(pthread_t * thread, void * (* run)(void *));
+
+#endif
@@ -0,0 +1,397 @@
+// statistics.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that accumulate scheduling
+// statistics over a run of oss. Per-process figures are kept by simPid until
+// the process terminates, at which point they are folded into run totals.
+// Metrics are written as "name value" lines so osssweep can aggregate them,
+// and counters are published to the stats page in shared memory for osstop.
+//
+// In streaming mode the totals are cleared when the warm-up ends, so the
+// metrics cover only the measurement, and each measurement window is printed
+// as one line of "name value" pairs when it ends, from the difference between
+// the totals then and when it began.
+//
+// The turnaround and response times of processes, and the real time from each
+// dispatch to its reply, are counted in log-linear buckets, eight to each
+// power of two, so their percentiles are written to the metrics file within
+// 1/16 of their value. The round trips are written with the cpu time and peak
+// resident set of oss, and unlike the rest are not checkpointed, as they
+// describe this invocation rather than the simulated run.
+//
+// Turnaround, ready wait, response and burst times are also kept in a sketch
+// (sketch.c) for each scheduling class and queue level, a few KB each however
+// long the run. With -d they are written to a file that ossmerge merges with
+// those of other runs.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "clock.h"
+#include "device.h"
+#include "multiQueue.h"
+#include "parameters.h"
+#include "pcb.h"
+#include "perrorExit.h"
+#include "seqlock.h"
+#include "statistics.h"
+#include "statsPage.h"
+
+// Per-process figures and run totals, saved whole in checkpoints
+static Statistics st;
+
+static Histogram roundTrips;		// Real time of each dispatch's reply
+static unsigned long long roundTripStart; // Time the last dispatch began
+
+// Returns the time on a clock in seconds
+static long double seconds(Clock time){
+	return time.seconds + (long double) time.nanoseconds / BILLION;
+}
+
+// Returns total / count, or zero if count is zero
+static long double mean(long double total, long count){
+	return count > 0 ? total / count : 0;
+}
+
+// Returns CLOCK_MONOTONIC in nanoseconds
+static unsigned long long monotonicNs(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * (unsigned long long) BILLION + now.tv_nsec;
+}
+
+// Returns the bucket counting a value of ns nanoseconds
+static int histogramBucket(unsigned long long ns){
+	int power;
+
+	if (ns < HISTOGRAM_SUB_BUCKETS) return ns;
+
+	power = 63 - __builtin_clzll(ns);
+	return (power - 2) * HISTOGRAM_SUB_BUCKETS
+	       + ((ns >> (power - 3)) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+// Returns the middle of the range of values a bucket counts
+static unsigned long long histogramValue(int bucket){
+	int power = bucket / HISTOGRAM_SUB_BUCKETS + 2;
+	unsigned long long width;
+
+	if (bucket < HISTOGRAM_SUB_BUCKETS) return bucket;
+
+	width = 1ULL << (power - 3);
+	return (HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS) * width
+	       + width / 2;
+}
+
+// Counts a value of ns nanoseconds
+static void histogramAdd(Histogram * h, unsigned long long ns){
+	h->counts[histogramBucket(ns)]++;
+	h->count++;
+}
+
+// Returns the p-th percentile of the values, or 0 if there were none
+static unsigned long long histogramPercentile(const Histogram * h, double p){
+	long rank = (long) (p * h->count + 0.5), seen = 0;
+	int i;
+
+	if (h->count == 0) return 0;
+	if (rank < 1) rank = 1;
+
+	for (i = 0; i < HISTOGRAM_BUCKETS; i++)
+		if ((seen += h->counts[i]) >= rank) break;
+
+	return histogramValue(i);
+}
+
+// Returns the nanoseconds of a clock
+static unsigned long long nanoseconds(Clock time){
+	return time.seconds * (unsigned long long) BILLION + time.nanoseconds;
+}
+
+// Notes the real time a dispatch begins
+void statRoundTripBegin(){
+	roundTripStart = monotonicNs();
+}
+
+// Counts the real time since the dispatch began, now that its reply is in
+void statRoundTripEnd(){
+	histogramAdd(&roundTrips, monotonicNs() - roundTripStart);
+}
+
+// Returns the sketch of a metric for the class and level of a process
+static Sketch * sketchOf(SketchMetric metric, const ProcessControlBlock * pcb){
+	return &st.sketches[metric][pcb->schedulingClass][pcb->priority];
+}
+
+// Records the generation of a process
+void statGeneration(int simPid, Clock time){
+	st.run.generated++;
+	st.dispatched[simPid] = 0;
+	st.timeBlocked[simPid] = zeroClock();
+	st.readySince[simPid] = time;
+}
+
+// Records the dispatch of a process and how long it was ready, noting the
+// first dispatch
+void statDispatch(const ProcessControlBlock * pcb, Clock time){
+	const ProcessAccounting * accounting = pcbAccounting(pcb);
+	int simPid = pcb->simPid;
+
+	st.run.dispatches++;
+	sketchAdd(sketchOf(WAIT_SKETCH, pcb),
+		  nanoseconds(clockDiff(time, st.readySince[simPid])));
+
+	if (!st.dispatched[simPid]){
+		st.dispatched[simPid] = 1;
+		st.firstDispatch[simPid] = time;
+		sketchAdd(sketchOf(RESPONSE_SKETCH, pcb),
+			  nanoseconds(clockDiff(time,
+						accounting->timeCreated)));
+	}
+}
+
+// Records the length of a burst and how it ended at the given time
+void statBurst(const ProcessControlBlock * pcb, char stateChar,
+	       unsigned int usedNano, Clock time){
+	incrementClock(&st.run.busyTime, newClock(0, usedNano));
+	sketchAdd(sketchOf(BURST_SKETCH, pcb), usedNano);
+
+	if (stateChar == USES_ALL_QUANTUM_CH){
+		st.run.fullQuanta++;
+		st.readySince[pcb->simPid] = time;
+	} else if (stateChar == PREEMPT_CH){
+		st.run.preemptions++;
+		st.readySince[pcb->simPid] = time;
+	} else if (stateChar == WAITING_FOR_IO_CH){
+		st.run.blocks++;
+		st.blockStart[pcb->simPid] = time;
+	}
+}
+
+// Records the time a blocked process was moved back to a ready queue
+void statWakeUp(int simPid, Clock time){
+	incrementClock(&st.timeBlocked[simPid],
+		       clockDiff(time, st.blockStart[simPid]));
+	st.readySince[simPid] = time;
+}
+
+// Folds the figures of a terminated process into the run totals
+void statTermination(const ProcessControlBlock * pcb, Clock time){
+	const ProcessAccounting * accounting = pcbAccounting(pcb);
+	Clock turnaroundTime, responseTime;
+	long double turnaround, cpu, blocked;
+
+	turnaroundTime = clockDiff(time, accounting->timeCreated);
+	responseTime = clockDiff(st.firstDispatch[pcb->simPid],
+				 accounting->timeCreated);
+	turnaround = seconds(turnaroundTime);
+	cpu = seconds(accounting->totalCpuTime);
+	blocked = seconds(st.timeBlocked[pcb->simPid]);
+
+	st.run.completed++;
+	st.run.cpuSeconds += cpu;
+	st.run.turnaroundSeconds += turnaround;
+	st.run.blockedSeconds += blocked;
+	st.run.waitSeconds += turnaround - cpu - blocked;
+	st.run.responseSeconds += seconds(responseTime);
+	histogramAdd(&st.turnarounds, nanoseconds(turnaroundTime));
+	histogramAdd(&st.responses, nanoseconds(responseTime));
+	sketchAdd(sketchOf(TURNAROUND_SKETCH, pcb),
+		  nanoseconds(turnaroundTime));
+}
+
+// Clears the stats page and marks it as belonging to this oss
+void statInitPage(StatsPage * page){
+	memset(page, 0, sizeof(StatsPage));
+	seqlockInit(&page->lock);
+	page->ossPid = getpid();
+}
+
+// Copies counters and queue depths to the stats page under its seqlock
+void statPublish(StatsPage * page, const MultiQueue * q, Clock now){
+	int i;
+
+	seqlockWriteBegin(&page->lock);
+
+	page->simTime = now;
+
+	page->generated = st.run.generated;
+	page->completed = st.run.completed;
+	page->dispatches = st.run.dispatches;
+	page->fullQuanta = st.run.fullQuanta;
+	page->preemptions = st.run.preemptions;
+	page->blocks = st.run.blocks;
+	page->busyTime = st.run.busyTime;
+
+	page->numQueueLevels = params.numQueueLevels;
+	for (i = 0; i < params.numQueueLevels; i++)
+		page->readyDepth[i] = q->readyQueues[i].count;
+	page->blockedCount = q->blockedCount;
+
+	seqlockWriteEnd(&page->lock);
+}
+
+// Marks the stats page as belonging to a finished run
+void statFinish(StatsPage * page){
+	seqlockWriteBegin(&page->lock);
+	page->finished = 1;
+	seqlockWriteEnd(&page->lock);
+}
+
+// Returns the totals gathered since base was copied from the run totals
+static Totals totalsSince(const Totals * base){
+	Totals since = st.run;
+
+	since.generated -= base->generated;
+	since.completed -= base->completed;
+	since.dispatches -= base->dispatches;
+	since.fullQuanta -= base->fullQuanta;
+	since.preemptions -= base->preemptions;
+	since.blocks -= base->blocks;
+	since.busyTime = clockDiff(st.run.busyTime, base->busyTime);
+	since.cpuSeconds -= base->cpuSeconds;
+	since.turnaroundSeconds -= base->turnaroundSeconds;
+	since.waitSeconds -= base->waitSeconds;
+	since.responseSeconds -= base->responseSeconds;
+	since.blockedSeconds -= base->blockedSeconds;
+
+	return since;
+}
+
+// Prints the metrics of totals gathered over elapsed seconds, separated by sep
+static void printTotals(FILE * fp, const Totals * t, long double elapsed,
+			const char * sep){
+	fprintf(fp, "generated %ld", t->generated);
+	fprintf(fp, "%scompleted %ld", sep, t->completed);
+	fprintf(fp, "%sdispatches %ld", sep, t->dispatches);
+	fprintf(fp, "%sfull_quanta %ld", sep, t->fullQuanta);
+	fprintf(fp, "%spreemptions %ld", sep, t->preemptions);
+	fprintf(fp, "%sblocks %ld", sep, t->blocks);
+	fprintf(fp, "%ssim_seconds %.9Lf", sep, elapsed);
+	fprintf(fp, "%sthroughput %.9Lf", sep,
+		elapsed > 0 ? t->completed / elapsed : 0);
+	fprintf(fp, "%scpu_utilization %.9Lf", sep,
+		elapsed > 0 ? t->cpuSeconds / elapsed : 0);
+	fprintf(fp, "%smean_turnaround %.9Lf", sep,
+		mean(t->turnaroundSeconds, t->completed));
+	fprintf(fp, "%smean_wait %.9Lf", sep,
+		mean(t->waitSeconds, t->completed));
+	fprintf(fp, "%smean_response %.9Lf", sep,
+		mean(t->responseSeconds, t->completed));
+	fprintf(fp, "%smean_blocked %.9Lf\n", sep,
+		mean(t->blockedSeconds, t->completed));
+}
+
+// Clears the totals at the end of the warm-up, starting the first window
+void statBeginMeasurement(Clock time){
+	memset(&st.run, 0, sizeof(Totals));
+	memset(&st.turnarounds, 0, sizeof(Histogram));
+	memset(&st.responses, 0, sizeof(Histogram));
+	memset(&roundTrips, 0, sizeof(Histogram));
+	memset(st.sketches, 0, sizeof(st.sketches));
+	st.windowBase = st.run;
+	st.measureStart = time;
+	st.windowStart = time;
+	beginDeviceMeasurement(time);
+}
+
+// Prints the metrics of the window ending at time on one line
+void statWindow(FILE * fp, int number, Clock time){
+	Totals window = totalsSince(&st.windowBase);
+
+	fprintf(fp, "window %d start %.9Lf ", number, seconds(st.windowStart));
+	printTotals(fp, &window, seconds(clockDiff(time, st.windowStart)), " ");
+	fflush(fp);
+
+	st.windowBase = st.run;
+	st.windowStart = time;
+}
+
+// Prints the metrics of the measurement as "name value" lines
+void printMetrics(FILE * fp, Clock endTime){
+	printTotals(fp, &st.run, seconds(clockDiff(endTime, st.measureStart)),
+		    "\n");
+}
+
+// Prints the 50th, 90th and 99th percentiles of a histogram in seconds
+static void printPercentiles(FILE * fp, const char * name, const Histogram * h){
+	fprintf(fp, "%s_p50 %.9Lf\n", name,
+		(long double) histogramPercentile(h, 0.5) / BILLION);
+	fprintf(fp, "%s_p90 %.9Lf\n", name,
+		(long double) histogramPercentile(h, 0.9) / BILLION);
+	fprintf(fp, "%s_p99 %.9Lf\n", name,
+		(long double) histogramPercentile(h, 0.99) / BILLION);
+}
+
+// Writes run metrics, then the round trips and resources of oss, to path
+void writeMetrics(const char * path, Clock endTime){
+	struct rusage usage;
+	FILE * fp;
+
+	if ((fp = fopen(path, "w")) == NULL)
+		perrorExit("statistics.c - failed to open metrics file");
+
+	printMetrics(fp, endTime);
+	printPercentiles(fp, "turnaround", &st.turnarounds);
+	printPercentiles(fp, "response", &st.responses);
+	printDeviceMetrics(fp, endTime);
+
+	fprintf(fp, "dispatch_p50_ns %llu\n",
+		histogramPercentile(&roundTrips, 0.5));
+	fprintf(fp, "dispatch_p90_ns %llu\n",
+		histogramPercentile(&roundTrips, 0.9));
+	fprintf(fp, "dispatch_p99_ns %llu\n",
+		histogramPercentile(&roundTrips, 0.99));
+
+	getrusage(RUSAGE_SELF, &usage);
+	fprintf(fp, "oss_cpu_seconds %.6f\n",
+		usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+		+ (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
+	fprintf(fp, "oss_max_rss_kb %ld\n", usage.ru_maxrss);
+
+	fclose(fp);
+}
+
+// Writes the non-empty sketches to path, a line each naming its metric, class
+// and level
+void writeSketches(const char * path){
+	static const char * metricNames[NUM_SKETCH_METRICS] = {
+		"turnaround", "wait", "response", "burst"
+	};
+	static const char * classNames[NUM_CLASSES] = {"normal", "real_time"};
+	const Sketch * sketch;
+	int metric, class, level;
+	FILE * fp;
+
+	if ((fp = fopen(path, "w")) == NULL)
+		perrorExit("statistics.c - failed to open sketch file");
+
+	fprintf(fp, "%s\n", SKETCH_FORMAT);
+	for (metric = 0; metric < NUM_SKETCH_METRICS; metric++)
+		for (class = 0; class < NUM_CLASSES; class++)
+			for (level = 0; level < MAX_QUEUE_LEVELS; level++){
+				sketch = &st.sketches[metric][class][level];
+				if (sketch->count == 0) continue;
+
+				fprintf(fp, "%s %s %d", metricNames[metric],
+					classNames[class], level);
+				writeSketch(fp, sketch);
+			}
+
+	fclose(fp);
+}
+
+// Copies the statistics gathered so far, for checkpoints
+void saveStatistics(Statistics * saved){
+	*saved = st;
+}
+
+// Replaces the statistics gathered so far with ones saved earlier
+void restoreStatistics(const Statistics * saved){
+	st = *saved;
+}
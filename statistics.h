@@ -0,0 +1,95 @@
+// statistics.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions that accumulate per-run scheduling
+// statistics in oss and write them to a metrics file read by osssweep.
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stdio.h>
+
+#include "clock.h"
+#include "multiQueue.h"
+#include "pcb.h"
+#include "quantum.h"
+#include "sketch.h"
+#include "statsPage.h"
+
+#define HISTOGRAM_SUB_BUCKETS 8	// Buckets to each power of two
+#define HISTOGRAM_BUCKETS (64 * HISTOGRAM_SUB_BUCKETS)
+
+// Nanosecond values counted in log-linear buckets
+typedef struct histogram {
+	long counts[HISTOGRAM_BUCKETS];	// Values counted by bucket
+	long count;			// Values counted
+} Histogram;
+
+// Times kept in a sketch for each scheduling class and queue level
+typedef enum SketchMetric {
+	TURNAROUND_SKETCH, WAIT_SKETCH, RESPONSE_SKETCH, BURST_SKETCH,
+	NUM_SKETCH_METRICS
+} SketchMetric;
+
+// Counts and sums of the processes and bursts of a stretch of the run
+typedef struct totals {
+	long generated;			// Processes generated
+	long completed;			// Processes terminated
+	long dispatches;		// Bursts started
+	long fullQuanta;		// Bursts that used the entire quantum
+	long preemptions;		// Bursts ended by preemption
+	long blocks;			// Bursts ended by waiting for I/O
+	Clock busyTime;			// Simulated time spent in bursts
+	long double cpuSeconds;		// Cpu time of completed processes
+	long double turnaroundSeconds;	// Summed turnaround times
+	long double waitSeconds;	// Summed time spent ready
+	long double responseSeconds;	// Summed creation to first dispatch
+	long double blockedSeconds;	// Summed time spent blocked
+} Totals;
+
+typedef struct statistics {
+
+	// Per-process figures, indexed by simPid
+	Clock firstDispatch[MAX_BLOCKS];	// Time of first dispatch
+	int dispatched[MAX_BLOCKS];		// Nonzero once dispatched
+	Clock blockStart[MAX_BLOCKS];		// Time the last block began
+	Clock timeBlocked[MAX_BLOCKS];		// Total time spent blocked
+	Clock readySince[MAX_BLOCKS];		// Time it last became ready
+
+	// Totals since the measurement began, at the start of the run unless
+	// a warm-up is set, and when the current window began
+	Totals run;
+	Totals windowBase;
+	Clock measureStart;
+	Clock windowStart;
+
+	// Turnaround and response times of processes completed since the
+	// measurement began
+	Histogram turnarounds;
+	Histogram responses;
+
+	// Times measured since the measurement began, by the class and queue
+	// level of the process when each was measured
+	Sketch sketches[NUM_SKETCH_METRICS][NUM_CLASSES][MAX_QUEUE_LEVELS];
+
+} Statistics;
+
+void statRoundTripBegin();
+void statRoundTripEnd();
+void statGeneration(int simPid, Clock time);
+void statDispatch(const ProcessControlBlock * pcb, Clock time);
+void statBurst(const ProcessControlBlock * pcb, char stateChar,
+	       unsigned int usedNano, Clock time);
+void statWakeUp(int simPid, Clock time);
+void statTermination(const ProcessControlBlock * pcb, Clock time);
+void statInitPage(StatsPage * page);
+void statPublish(StatsPage * page, const MultiQueue * q, Clock now);
+void statFinish(StatsPage * page);
+void statBeginMeasurement(Clock time);
+void statWindow(FILE * fp, int number, Clock time);
+void printMetrics(FILE * fp, Clock endTime);
+void writeMetrics(const char * path, Clock endTime);
+void writeSketches(const char * path);
+void saveStatistics(Statistics * saved);
+void restoreStatistics(const Statistics * saved);
+
+#endif
@@ -0,0 +1,36 @@
+// statsPage.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains the definition of the StatsPage type, a snapshot of
+// counters and queue depths that oss publishes in its shared memory region
+// once per loop iteration so osstop can display them while oss runs.
+
+#ifndef STATSPAGE_H
+#define STATSPAGE_H
+
+#include <sys/types.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "seqlock.h"
+
+typedef struct statsPage {
+	Seqlock lock;			// Guards every field below
+
+	pid_t ossPid;			// Real pid of the publishing oss
+	int finished;			// Nonzero once oss is done scheduling
+	Clock simTime;			// System clock at publication
+
+	long generated;			// Processes generated
+	long completed;			// Processes terminated
+	long dispatches;		// Bursts started
+	long fullQuanta;		// Bursts that used the entire quantum
+	long preemptions;		// Bursts ended by preemption
+	long blocks;			// Bursts ended by waiting for I/O
+	Clock busyTime;			// Simulated time spent in bursts
+
+	int numQueueLevels;		// Levels in use in readyDepth
+	int readyDepth[MAX_QUEUE_LEVELS]; // Pcbs in each ready queue
+	int blockedCount;		// Pcbs in the blocked queue
+} StatsPage;
+
+#endif
@@ -0,0 +1,455 @@
+// sweep.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains osssweep, a program which runs oss once for every
+// combination of a grid of parameter values and a list of seeds. Runs are
+// isolated from one another by giving each its own process group and IPC
+// instance number, and as many run at once as there are cores unless -j says
+// otherwise. The metrics written by each run are aggregated into one table
+// with the mean and 95% confidence interval of every metric at each point.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "confidence.h"
+#include "constants.h"
+#include "perrorExit.h"
+
+// A parameter varied by the sweep and the oss option that sets it
+typedef struct sweepParameter {
+	const char * name;
+	const char * option;
+	char * values[MAX_SWEEP_VALUES];
+	int count;
+} SweepParameter;
+
+// A single run of oss at one grid point with one seed
+typedef struct job {
+	int point;			// Index of the grid point
+	unsigned int seed;		// Seed passed to oss
+	pid_t pid;			// Real pid while running
+	int slot;			// Slot of the run while running
+	int succeeded;			// Nonzero if oss exited normally
+	double metrics[MAX_METRICS];	// Metrics read after the run
+} Job;
+
+static void parseGrid(char * arg);
+static void parseSeeds(char * arg);
+static void runJobs(int maxRunning, int firstInstance, const char * logDir);
+static void launchJob(int jobIndex, int instance, const char * logDir);
+static void readMetrics(int jobIndex);
+static void pointValue(int point, int param, char ** value);
+static void summarize(int point, int metric, int * n, double * mean,
+		      double * ci);
+static void writeCsv(FILE * fp);
+static void writeJson(FILE * fp);
+static void usage();
+
+// Parameters that may be swept, in the order their columns are printed
+static SweepParameter sweepParams[] = {
+	{"quantum", "-q"},
+	{"levels", "-l"},
+	{"rtprob", "-r"},
+	{"aging", "-a"},
+	{"util", "-u"},
+	{"percentile", "-Q"}
+};
+static const int numSweepParams = sizeof(sweepParams) / sizeof(SweepParameter);
+
+static unsigned int seeds[MAX_SWEEP_SEEDS];	// Seeds run at every point
+static int numSeeds = 0;
+
+static int numPoints = 1;	// Number of points in the grid
+static Job * jobs = NULL;	// One job per point and seed
+static int numJobs = 0;
+
+static char * metricNames[MAX_METRICS];	// Names read from the first run
+static int numMetrics = 0;
+
+static char tmpDir[] = "/tmp/osssweep.XXXXXX"; // Holds metrics files
+
+int main(int argc, char * argv[]){
+	int opt, i;
+	int maxRunning = sysconf(_SC_NPROCESSORS_ONLN); // Runs at once
+	int firstInstance = 1;	  // IPC instance of the first job
+	char * csvPath = NULL;	  // Output path of the CSV table
+	char * jsonPath = NULL;	  // Output path of the JSON table
+	char * logDir = NULL;	  // Directory for oss logs, if kept
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "j:s:n:i:c:J:d:h")) != -1){
+		switch (opt){
+		case 'j':
+			maxRunning = atoi(optarg);
+			break;
+		case 's':
+			parseSeeds(optarg);
+			break;
+		case 'n':
+			if (atoi(optarg) < 1 || atoi(optarg) > MAX_SWEEP_SEEDS)
+				usage();
+			for (numSeeds = 0; numSeeds < atoi(optarg); numSeeds++)
+				seeds[numSeeds] = BASE_SEED + numSeeds;
+			break;
+		case 'i':
+			firstInstance = atoi(optarg);
+			break;
+		case 'c':
+			csvPath = optarg;
+			break;
+		case 'J':
+			jsonPath = optarg;
+			break;
+		case 'd':
+			logDir = optarg;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	// Remaining arguments define the grid
+	for (i = optind; i < argc; i++)
+		parseGrid(argv[i]);
+
+	if (maxRunning < 1) maxRunning = 1;
+
+	// Uses default seeds if none were given
+	if (numSeeds == 0)
+		for (numSeeds = 0; numSeeds < DEFAULT_SWEEP_SEEDS; numSeeds++)
+			seeds[numSeeds] = BASE_SEED + numSeeds;
+
+	// Creates one job per grid point and seed
+	numJobs = numPoints * numSeeds;
+	if ((jobs = calloc(numJobs, sizeof(Job))) == NULL)
+		perrorExit("Failed to allocate jobs");
+	for (i = 0; i < numJobs; i++){
+		jobs[i].point = i / numSeeds;
+		jobs[i].seed = seeds[i % numSeeds];
+	}
+
+	// Each running job uses the instance of its slot
+	if (maxRunning > numJobs) maxRunning = numJobs;
+	if (firstInstance < 0 || firstInstance + maxRunning > MAX_INSTANCES){
+		fprintf(stderr, "%s: instances %d to %d are not all below %d\n",
+			exeName, firstInstance, firstInstance + maxRunning - 1,
+			MAX_INSTANCES);
+		exit(1);
+	}
+
+	if (mkdtemp(tmpDir) == NULL)
+		perrorExit("Failed to create temporary directory");
+
+	runJobs(maxRunning, firstInstance, logDir);
+
+	// Writes the aggregated table
+	if (csvPath != NULL){
+		FILE * fp = fopen(csvPath, "w");
+		if (fp == NULL) perrorExit("Failed to open CSV file");
+		writeCsv(fp);
+		fclose(fp);
+	}
+	if (jsonPath != NULL){
+		FILE * fp = fopen(jsonPath, "w");
+		if (fp == NULL) perrorExit("Failed to open JSON file");
+		writeJson(fp);
+		fclose(fp);
+	}
+	if (csvPath == NULL && jsonPath == NULL)
+		writeCsv(stdout);
+
+	rmdir(tmpDir);
+	return 0;
+}
+
+// Adds the values of a "name=v1,v2,..." argument to the grid
+static void parseGrid(char * arg){
+	char * value;
+	char * equals = strchr(arg, '=');
+	int i;
+
+	if (equals == NULL) usage();
+	*equals = '\0';
+
+	// Finds the named parameter
+	for (i = 0; i < numSweepParams; i++)
+		if (strcmp(sweepParams[i].name, arg) == 0) break;
+	if (i == numSweepParams || sweepParams[i].count > 0) usage();
+
+	// Splits the comma separated values
+	for (value = strtok(equals + 1, ","); value != NULL;
+	     value = strtok(NULL, ",")){
+		if (sweepParams[i].count == MAX_SWEEP_VALUES) usage();
+		sweepParams[i].values[sweepParams[i].count++] = value;
+	}
+
+	if (sweepParams[i].count == 0) usage();
+	numPoints *= sweepParams[i].count;
+}
+
+// Reads a comma separated list of seeds
+static void parseSeeds(char * arg){
+	char * seed;
+
+	numSeeds = 0;
+	for (seed = strtok(arg, ","); seed != NULL; seed = strtok(NULL, ",")){
+		if (numSeeds == MAX_SWEEP_SEEDS) usage();
+		seeds[numSeeds++] = strtoul(seed, NULL, 10);
+	}
+}
+
+// Runs every job, keeping up to maxRunning of them in flight at once. Each
+// job runs in a free slot and uses the instance of that slot, so a sweep of
+// any size needs only maxRunning instances.
+static void runJobs(int maxRunning, int firstInstance, const char * logDir){
+	int next = 0;		// Index of the next job to launch
+	int running = 0;	// Number of jobs in flight
+	int * slotUsed;		// Nonzero for slots of jobs in flight
+	int status, i, slot;
+	pid_t pid;
+
+	if ((slotUsed = calloc(maxRunning, sizeof(int))) == NULL)
+		perrorExit("Failed to allocate slots");
+
+	while (next < numJobs || running > 0){
+
+		// Fills free slots
+		while (running < maxRunning && next < numJobs){
+			slot = 0;
+			while (slotUsed[slot]) slot++;
+			slotUsed[slot] = 1;
+			jobs[next].slot = slot;
+			launchJob(next, firstInstance + slot, logDir);
+			next++;
+			running++;
+		}
+
+		// Waits for any job to finish
+		if ((pid = wait(&status)) == -1)
+			perrorExit("Failed waiting for oss");
+
+		for (i = 0; i < numJobs; i++)
+			if (jobs[i].pid == pid) break;
+		if (i == numJobs) continue;
+
+		running--;
+		slotUsed[jobs[i].slot] = 0;
+		jobs[i].pid = 0;
+		jobs[i].succeeded = WIFEXITED(status)
+				    && WEXITSTATUS(status) == 0;
+
+		if (jobs[i].succeeded)
+			readMetrics(i);
+		else
+			fprintf(stderr, "%s: run %d (seed %u) failed\n",
+				exeName, i, jobs[i].seed);
+	}
+
+	free(slotUsed);
+}
+
+// Forks and execs oss for a job in its own process group
+static void launchJob(int jobIndex, int instance, const char * logDir){
+	char * args[2 * MAX_SWEEP_PARAMS + 12];
+	char seed[BUFF_SZ], inst[BUFF_SZ];
+	char logPath[BUFF_SZ], metricsPath[BUFF_SZ];
+	int i, n = 0;
+	pid_t pid;
+
+	// Builds the argument vector of oss
+	sprintf(seed, "%u", jobs[jobIndex].seed);
+	sprintf(inst, "%d", instance);
+	sprintf(metricsPath, "%s/%d", tmpDir, jobIndex);
+	if (logDir != NULL)
+		snprintf(logPath, BUFF_SZ, "%s/oss_log.%d", logDir, jobIndex);
+	else
+		strcpy(logPath, "/dev/null");
+
+	args[n++] = OSS_PATH;
+	args[n++] = "-s"; args[n++] = seed;
+	args[n++] = "-i"; args[n++] = inst;
+	args[n++] = "-L"; args[n++] = logPath;
+	args[n++] = "-m"; args[n++] = metricsPath;
+	for (i = 0; i < numSweepParams; i++){
+		if (sweepParams[i].count == 0) continue;
+		args[n++] = (char *) sweepParams[i].option;
+		pointValue(jobs[jobIndex].point, i, &args[n++]);
+	}
+	args[n] = NULL;
+
+	if ((pid = fork()) == -1)
+		perrorExit("Failed to fork");
+
+	// Child isolates itself so oss's cleanup can't reach other runs
+	if (pid == 0){
+		setpgid(0, 0);
+		execv(OSS_PATH, args);
+		perrorExit("Failed to exec oss");
+	}
+
+	jobs[jobIndex].pid = pid;
+}
+
+// Reads the metrics file written by a finished job, then removes it
+static void readMetrics(int jobIndex){
+	char path[BUFF_SZ], name[BUFF_SZ];
+	double value;
+	int i, m = 0;
+	FILE * fp;
+
+	sprintf(path, "%s/%d", tmpDir, jobIndex);
+	if ((fp = fopen(path, "r")) == NULL){
+		jobs[jobIndex].succeeded = 0;
+		return;
+	}
+
+	while (fscanf(fp, "%99s %lf", name, &value) == 2 && m < MAX_METRICS){
+
+		// Learns metric names from the first file read
+		if (numMetrics == m){
+			metricNames[m] = strdup(name);
+			numMetrics++;
+		}
+
+		// Matches by name in case files differ in order
+		for (i = 0; i < numMetrics; i++)
+			if (strcmp(metricNames[i], name) == 0) break;
+		if (i < numMetrics) jobs[jobIndex].metrics[i] = value;
+		m++;
+	}
+
+	fclose(fp);
+	unlink(path);
+}
+
+// Gets the value of a swept parameter at a grid point
+static void pointValue(int point, int param, char ** value){
+	int i;
+
+	// Decodes the point index as a mixed radix number
+	for (i = numSweepParams - 1; i >= 0; i--){
+		if (sweepParams[i].count == 0) continue;
+		if (i == param){
+			*value = sweepParams[i].values[point
+						       % sweepParams[i].count];
+			return;
+		}
+		point /= sweepParams[i].count;
+	}
+}
+
+// Computes the mean and 95% confidence half-width of a metric at a point
+static void summarize(int point, int metric, int * n, double * mean,
+		      double * ci){
+	double sum = 0, squares = 0, x;
+	int i;
+
+	*n = 0;
+	for (i = point * numSeeds; i < (point + 1) * numSeeds; i++){
+		if (!jobs[i].succeeded) continue;
+		sum += jobs[i].metrics[metric];
+		(*n)++;
+	}
+
+	*mean = *n > 0 ? sum / *n : 0;
+	*ci = 0;
+	if (*n < 2) return;
+
+	for (i = point * numSeeds; i < (point + 1) * numSeeds; i++){
+		if (!jobs[i].succeeded) continue;
+		x = jobs[i].metrics[metric] - *mean;
+		squares += x * x;
+	}
+
+	*ci = tCritical(*n - 1) * sqrt(squares / (*n - 1)) / sqrt(*n);
+}
+
+// Writes one CSV row per grid point
+static void writeCsv(FILE * fp){
+	int point, i, n;
+	double mean, ci;
+	char * value;
+
+	// Header
+	for (i = 0; i < numSweepParams; i++)
+		if (sweepParams[i].count > 0)
+			fprintf(fp, "%s,", sweepParams[i].name);
+	fprintf(fp, "runs");
+	for (i = 0; i < numMetrics; i++)
+		fprintf(fp, ",%s_mean,%s_ci95", metricNames[i], metricNames[i]);
+	fprintf(fp, "\n");
+
+	// Rows
+	for (point = 0; point < numPoints; point++){
+		for (i = 0; i < numSweepParams; i++){
+			if (sweepParams[i].count == 0) continue;
+			pointValue(point, i, &value);
+			fprintf(fp, "%s,", value);
+		}
+
+		summarize(point, 0, &n, &mean, &ci);
+		fprintf(fp, "%d", n);
+		for (i = 0; i < numMetrics; i++){
+			summarize(point, i, &n, &mean, &ci);
+			fprintf(fp, ",%.9g,%.9g", mean, ci);
+		}
+		fprintf(fp, "\n");
+	}
+}
+
+// Writes an array with one object per grid point
+static void writeJson(FILE * fp){
+	int point, i, n, first;
+	double mean, ci;
+	char * value;
+
+	fprintf(fp, "[\n");
+	for (point = 0; point < numPoints; point++){
+
+		// Parameters of the point
+		fprintf(fp, "  {\"params\": {");
+		first = 1;
+		for (i = 0; i < numSweepParams; i++){
+			if (sweepParams[i].count == 0) continue;
+			pointValue(point, i, &value);
+			fprintf(fp, "%s\"%s\": %s", first ? "" : ", ",
+				sweepParams[i].name, value);
+			first = 0;
+		}
+
+		// Summarized metrics
+		summarize(point, 0, &n, &mean, &ci);
+		fprintf(fp, "}, \"runs\": %d, \"metrics\": {", n);
+		for (i = 0; i < numMetrics; i++){
+			summarize(point, i, &n, &mean, &ci);
+			fprintf(fp, "%s\"%s\": {\"mean\": %.9g, \"ci95\": %.9g}",
+				i == 0 ? "" : ", ", metricNames[i], mean, ci);
+		}
+		fprintf(fp, "}}%s\n", point < numPoints - 1 ? "," : "");
+	}
+	fprintf(fp, "]\n");
+}
+
+// Prints the accepted options to stderr and exits
+static void usage(){
+	fprintf(stderr,
+		"Usage: %s [options] [name=v1,v2,...]...\n"
+		"  names     quantum, levels, rtprob, aging, util, percentile\n"
+		"            (up to %d values each)\n"
+		"  -j n      runs at once (default: online cores)\n"
+		"  -s list   comma separated seeds, up to %d\n"
+		"  -n n      runs seeds %d through %d + n - 1, n up to %d\n"
+		"            (default n = %d)\n"
+		"  -i n      first IPC instance of the runs (default 1)\n"
+		"  -c path   writes the table as CSV\n"
+		"  -J path   writes the table as JSON\n"
+		"  -d dir    keeps the log of each run in dir\n",
+		exeName, MAX_SWEEP_VALUES, MAX_SWEEP_SEEDS, BASE_SEED,
+		BASE_SEED, MAX_SWEEP_SEEDS, DEFAULT_SWEEP_SEEDS);
+	exit(1);
+}
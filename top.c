@@ -0,0 +1,196 @@
+// top.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains osstop, a program which attaches read-only to the shared
+// memory region of a running oss and periodically displays the counters and
+// queue depths oss publishes in its stats page. Reads go through the page's
+// seqlock, so osstop never makes oss wait. With -q it also lists the simPids
+// in each queue, read straight from the multi-level queue in shared memory;
+// those reads aren't synchronized, so a list may be caught mid-update.
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "clock.h"
+#include "constants.h"
+#include "getSharedMemoryPointers.h"
+#include "multiQueue.h"
+#include "parameters.h"
+#include "perrorExit.h"
+#include "seqlock.h"
+#include "sharedMemory.h"
+#include "statsPage.h"
+
+static void readStatsPage(const StatsPage * page, StatsPage * copy);
+static void display(const StatsPage * now, const StatsPage * before,
+		    double elapsed);
+static void displayQueue(const char * name, const Queue * q);
+static double seconds(Clock time);
+static double monotonicSeconds();
+static void usage();
+
+int main(int argc, char * argv[]){
+	char * shm = NULL;		// Read-only shared memory region
+	StatsPage current, previous;	// Consecutive snapshots
+	double delay = 1.0;		// Seconds between refreshes
+	int iterations = 0;		// Refreshes before exiting, 0 for no limit
+	int showQueues = 0;		// Nonzero if queue contents are listed
+	double now, then;
+	int opt, i;
+
+	exeName = argv[0];
+
+	while ((opt = getopt(argc, argv, "i:d:n:qh")) != -1){
+		switch (opt){
+		case 'i':
+			params.instance = atoi(optarg);
+			break;
+		case 'd':
+			delay = atof(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 'q':
+			showQueues = 1;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	// Waits for oss to create its shared memory region
+	while ((shm = attachStatsReadOnly()) == NULL){
+		fprintf(stderr, "%s: waiting for oss instance %d\n", exeName,
+			params.instance);
+		usleep(delay * MILLION);
+	}
+
+	readStatsPage(getStatsPage(shm), &previous);
+	then = monotonicSeconds();
+
+	for (i = 0; iterations == 0 || i < iterations; i++){
+		usleep(delay * MILLION);
+
+		readStatsPage(getStatsPage(shm), &current);
+		now = monotonicSeconds();
+
+		display(&current, &previous, now - then);
+
+		// Lists queue contents
+		if (showQueues){
+			MultiQueue * q = getMultiQueue(shm);
+			char name[BUFF_SZ];
+			int j;
+
+			for (j = 0; j < current.numQueueLevels
+			     && j < MAX_QUEUE_LEVELS; j++){
+				sprintf(name, "queue %d", j);
+				displayQueue(name, &q->readyQueues[j]);
+			}
+			displayQueue("blocked", &q->blockedQueue);
+			printf("\n");
+			fflush(stdout);
+		}
+
+		// Stops once oss is done or gone
+		if (current.finished || (current.ossPid > 0
+		    && kill(current.ossPid, 0) == -1 && errno == ESRCH))
+			break;
+
+		previous = current;
+		then = now;
+	}
+
+	detach(shm);
+	return 0;
+}
+
+// Copies the stats page, retrying until the copy isn't torn by a write
+static void readStatsPage(const StatsPage * page, StatsPage * copy){
+	unsigned int start;
+
+	do {
+		start = seqlockReadBegin(&page->lock);
+		memcpy(copy, page, sizeof(StatsPage));
+	} while (seqlockReadRetry(&page->lock, start));
+}
+
+// Prints a snapshot and the rates since the previous one
+static void display(const StatsPage * now, const StatsPage * before,
+		    double elapsed){
+	double simElapsed = seconds(now->simTime) - seconds(before->simTime);
+	double busyElapsed = seconds(now->busyTime) - seconds(before->busyTime);
+	int i;
+
+	// Clears the screen when attached to a terminal
+	if (isatty(STDOUT_FILENO)) printf("\033[H\033[2J");
+
+	printf("oss pid %d instance %d%s   sim time %03u : %09u\n",
+	       now->ossPid, params.instance, now->finished ? " (finished)" : "",
+	       now->simTime.seconds, now->simTime.nanoseconds);
+
+	printf("dispatch rate   %10.1f /s real  %10.3f /s simulated\n",
+	       elapsed > 0 ? (now->dispatches - before->dispatches) / elapsed : 0,
+	       simElapsed > 0 ? (now->dispatches - before->dispatches)
+				/ simElapsed : 0);
+
+	printf("utilization     %9.4f%% recent  %9.4f%% overall\n",
+	       simElapsed > 0 ? 100 * busyElapsed / simElapsed : 0,
+	       seconds(now->simTime) > 0 ? 100 * seconds(now->busyTime)
+					   / seconds(now->simTime) : 0);
+
+	printf("processes       %10ld generated %10ld completed\n",
+	       now->generated, now->completed);
+
+	printf("bursts          %10ld full  %10ld preempted  %10ld blocked\n",
+	       now->fullQuanta, now->preemptions, now->blocks);
+
+	// Queue depths
+	for (i = 0; i < now->numQueueLevels && i < MAX_QUEUE_LEVELS; i++)
+		printf("queue %d         %10d\n", i, now->readyDepth[i]);
+	printf("blocked         %10d\n\n", now->blockedCount);
+
+	fflush(stdout);
+}
+
+// Prints the simPids in a queue from front to back
+static void displayQueue(const char * name, const Queue * q){
+	Queue copy = *q;
+
+	// Guards against a count torn by a concurrent update
+	if (copy.count < 0 || copy.count > QUEUE_CAPACITY) copy.count = 0;
+
+	printf("%-15s", name);
+	printQueue(stdout, &copy);
+	printf("\n");
+}
+
+// Returns the time on a clock in seconds
+static double seconds(Clock time){
+	return time.seconds + (double) time.nanoseconds / BILLION;
+}
+
+// Returns the time on the monotonic clock in seconds
+static double monotonicSeconds(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (double) ts.tv_nsec / BILLION;
+}
+
+// Prints the accepted options to stderr and exits
+static void usage(){
+	fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  -i n      instance number of the oss to watch (default 0)\n"
+		"  -d sec    seconds between refreshes (default 1)\n"
+		"  -n n      exits after n refreshes\n"
+		"  -q        lists the simPids in each queue\n",
+		exeName);
+	exit(1);
+}
@@ -0,0 +1,122 @@
+// trace.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that write a Chrome trace-event
+// file of a run. Each simPid has a track in the "processes" group showing
+// the state it was in over simulated time (ready, running, blocked or
+// preempted) as complete events, with instant events for its generation and
+// termination. The "queues" group has a counter track with the depth of each
+// ready queue and of the blocked queue. Times are simulated microseconds.
+//
+// A state is written when it ends, since a complete event needs its length,
+// so each simPid's current state and the time it began are kept here.
+
+#include <stdio.h>
+
+#include "constants.h"
+#include "perrorExit.h"
+#include "trace.h"
+
+#define PROCESSES_PID 1		// Trace process holding the simPid tracks
+#define QUEUES_PID 2		// Trace process holding the queue counters
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+static FILE * trace = NULL;
+static const char * states[MAX_BLOCKS];	// Current state of each simPid
+static Clock stateStart[MAX_BLOCKS];	// Time each state began
+static int depths[MAX_QUEUE_LEVELS + 1]; // Ready queues, then blocked queue
+static Clock lastTime;			// Latest time traced
+
+// Writes a Clock as microseconds with nanosecond precision
+static void printMicroseconds(Clock time){
+	fprintf(trace, "%llu.%03u",
+		time.seconds * 1000000ULL + time.nanoseconds / 1000,
+		time.nanoseconds % 1000);
+}
+
+// Begins an event of type ph named name in a track, ending with its time
+static void beginEvent(const char * name, const char * ph, int pid, int tid,
+		       Clock time){
+	fprintf(trace, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":%d,"
+		"\"tid\":%d,\"ts\":", name, ph, pid, tid);
+	printMicroseconds(time);
+
+	if (clockCompare(time, lastTime) > 0) lastTime = time;
+}
+
+// Creates the trace file and names its groups and queue tracks
+void openTrace(const char * path){
+	int i;
+
+	if ((trace = fopen(path, "w")) == NULL)
+		perrorExit("trace.c - failed to open trace file");
+	setvbuf(trace, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+	fprintf(trace, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"args\":{\"name\":\"processes\"}},\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+		"\"args\":{\"name\":\"queues\"}}", PROCESSES_PID, QUEUES_PID);
+
+	for (i = 0; i < MAX_BLOCKS; i++)
+		fprintf(trace, ",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+			"\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"simPid %d\"}}",
+			PROCESSES_PID, i, i);
+
+	lastTime = zeroClock();
+}
+
+// Ends the current state of simPid at time and begins state, if not NULL
+void traceState(int simPid, const char * state, Clock time){
+	if (trace == NULL) return;
+
+	if (states[simPid] != NULL){
+		beginEvent(states[simPid], "X", PROCESSES_PID, simPid,
+			   stateStart[simPid]);
+		fprintf(trace, ",\"dur\":");
+		printMicroseconds(clockDiff(time, stateStart[simPid]));
+		fprintf(trace, "}");
+	}
+
+	states[simPid] = state;
+	stateStart[simPid] = time;
+	if (clockCompare(time, lastTime) > 0) lastTime = time;
+}
+
+// Marks an event in the track of simPid
+void traceInstant(int simPid, const char * name, Clock time){
+	if (trace == NULL) return;
+
+	beginEvent(name, "i", PROCESSES_PID, simPid, time);
+	fprintf(trace, ",\"s\":\"t\"}");
+}
+
+// Changes the depth of a ready queue, or the blocked queue if queueNum is -1
+void traceDepth(int queueNum, int change, Clock time){
+	int i = queueNum == -1 ? MAX_QUEUE_LEVELS : queueNum;
+	char name[BUFF_SZ];
+
+	if (trace == NULL) return;
+
+	depths[i] += change;
+
+	if (queueNum == -1)
+		sprintf(name, "blocked");
+	else
+		sprintf(name, "queue %d", queueNum);
+	beginEvent(name, "C", QUEUES_PID, 0, time);
+	fprintf(trace, ",\"args\":{\"depth\":%d}}", depths[i]);
+}
+
+// Ends every open state at the latest time traced and closes the file
+void closeTrace(){
+	int i;
+
+	if (trace == NULL) return;
+
+	for (i = 0; i < MAX_BLOCKS; i++)
+		traceState(i, NULL, lastTime);
+
+	fprintf(trace, "\n]}\n");
+	fclose(trace);
+	trace = NULL;
+}
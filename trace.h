@@ -0,0 +1,18 @@
+// trace.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions that write the scheduling
+// timeline of a run as Chrome trace-event JSON, which trace viewers such as
+// Perfetto and chrome://tracing can load. They are called from logging.c.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "clock.h"
+
+void openTrace(const char * path);
+void traceState(int simPid, const char * state, Clock time);
+void traceInstant(int simPid, const char * name, Clock time);
+void traceDepth(int queueNum, int change, Clock time);
+void closeTrace();
+
+#endif
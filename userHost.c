@@ -0,0 +1,158 @@
+// userHost.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains a program which simulates every process managed by oss
+// with -U, running each as a coroutine with a stack of its own instead of as
+// a userProgram.
+//
+// oss sends the host one message per dispatch, carrying the processes it has
+// generated since the last one. The host starts a coroutine for each of them,
+// then switches to the dispatched process, which decides how it uses its
+// quantum as userProgram would and switches back with its reply. The host
+// sends the reply the way userProgram does, so oss receives it unchanged.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "burst.h"
+#include "clock.h"
+#include "completionRing.h"
+#include "eventLoop.h"
+#include "getSharedMemoryPointers.h"
+#include "message.h"
+#include "parameters.h"
+#include "pcb.h"
+#include "perrorExit.h"
+#include "randomGen.h"
+
+typedef struct hostedProcess {
+	ucontext_t context;		// Where the process resumes
+	RandomGenerator generator;	// Draws of this process only
+	unsigned int generation;	// Lifetime of its simPid
+	char msgBuff[MSG_SZ];		// Dispatch message, then the reply
+	int running;			// Nonzero from spawn until termination
+} HostedProcess;
+
+static void spawnProcess(const HostSpawn * spawn, unsigned int seed,
+			 Clock time);
+static void runProcess(int simPid);
+
+static HostedProcess processes[MAX_BLOCKS];
+static ucontext_t hostContext;	// Where each process switches back to
+static char * stacks;		// One stack of HOST_STACK_SIZE per simPid
+
+int main(int argc, char * argv[]){
+	char * shm;				// Pointer to shared memory
+	SharedClock * systemClock;		// Shared memory system clock
+	ProcessControlBlock * processTable;	// Shared memory process table
+
+	int dispatchMqId;	// Message queue ID for dispatch messages
+	int replyMqId;		// Message queue ID for replying to oss
+	HostMessage msg;	// Processes to start and the one dispatched
+	HostedProcess * process;// Process dispatched
+	CompletionRing * ring;	// Ring replies are published to with -T ring
+	Completion reply;	// Reply published to the ring
+	int i;
+
+	exeName = argv[0];	    // Assigns exeName for perrorExit
+
+	unsigned int seed = strtoul(argv[1], NULL, 10); // Seed of the run
+	params.instance = atoi(argv[2]); // Instance used to offset IPC keys
+	params.shmFd = atoi(argv[3]);	 // Region descriptor, or -1 for SysV
+	int doorbell = atoi(argv[4]);	 // Rung after each reply to wake oss
+	params.replyTransport = atoi(argv[5]); // Queue or ring for replies
+	params.interruptProbability = atof(argv[6]); // Used by simulateBurst
+	params.numDevices = atoi(argv[7]); // Devices replies may name, or 0
+	errorNotifyPid = getppid();	 // Lets oss clean up on errors
+
+	// Attatches to shared memory and gets pointers
+	getSharedMemoryPointers(&shm, &systemClock, &processTable, 0);
+	ring = getCompletionRing(shm);
+
+	// Reserves the stacks, which only use memory as they are touched
+	stacks = mmap(NULL, (size_t) HOST_STACK_SIZE * MAX_BLOCKS,
+		      PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+		      -1, 0);
+	if (stacks == MAP_FAILED)
+		perrorExit("Failed to map coroutine stacks");
+
+	// Gets message queues
+	dispatchMqId = getMessageQueue(instanceKey(DISPATCH_MQ_KEY), MQ_PERMS);
+	replyMqId = getMessageQueue(instanceKey(REPLY_MQ_KEY), MQ_PERMS);
+
+	while (1){
+
+		// Waits for the next dispatch and the processes before it
+		waitForHostMessage(dispatchMqId, &msg);
+		for (i = 0; i < msg.numSpawns; i++)
+			spawnProcess(&msg.spawns[i], seed, msg.time);
+
+		// Exits if the process was never started or has terminated
+		process = &processes[msg.simPid];
+		if (!process->running
+		    || processTable[msg.simPid].generation
+		       != process->generation)
+			perrorExit("Dispatched after its lifetime ended");
+
+		// Runs the process until it has its reply
+		strcpy(process->msgBuff, msg.quantum);
+		useRandomGenerator(&process->generator);
+		if (swapcontext(&hostContext, &process->context) == -1)
+			perrorExit("Failed to switch to a hosted process");
+
+		// Indicates quantum use and whether terminating or blocking
+		if (params.replyTransport == RING_REPLIES){
+			reply.simPid = msg.simPid;
+			reply.generation = process->generation;
+			memcpy(reply.msgText, process->msgBuff, MSG_SZ);
+			publishCompletion(ring, &reply);
+		} else {
+			sendMessage(replyMqId, process->msgBuff,
+				    msg.simPid + 1);
+			ringDoorbell(doorbell);
+		}
+	}
+
+	return 0;
+}
+
+// Creates the coroutine of a new process, which first runs when dispatched
+static void spawnProcess(const HostSpawn * spawn, unsigned int seed,
+			 Clock time){
+	HostedProcess * process = &processes[spawn->simPid];
+
+	if (spawn->simPid < 0 || spawn->simPid >= MAX_BLOCKS
+	    || process->running)
+		perrorExit("Started a process whose simPid is in use");
+
+	if (getcontext(&process->context) == -1)
+		perrorExit("Failed to get a context");
+	process->context.uc_stack.ss_sp = stacks
+					  + (size_t) HOST_STACK_SIZE
+					    * spawn->simPid;
+	process->context.uc_stack.ss_size = HOST_STACK_SIZE;
+	process->context.uc_link = &hostContext;
+	makecontext(&process->context, (void (*)()) runProcess, 1,
+		    spawn->simPid);
+
+	// Seeds off a function of the process id, as userProgram does
+	seedRandomGenerator(&process->generator,
+			    seed + spawn->simPid + time.nanoseconds);
+	process->generation = spawn->generation;
+	process->running = 1;
+}
+
+// Body of each coroutine, which yields its reply to every dispatch and
+// returns to the host after its last
+static void runProcess(int simPid){
+	HostedProcess * process = &processes[simPid];
+
+	while (!simulateBurst(process->msgBuff))
+		swapcontext(&process->context, &hostContext);
+
+	process->running = 0;
+}
@@ -0,0 +1,87 @@
+// workload.c was created by Mark Renard on 10/19/2026.
+//
+// This file contains definitions of functions that run the workload of a
+// user process with -X. The workload spins in chunks of WORKLOAD_CHUNK_US
+// microseconds, sized by a calibration oss makes once, and checks the cpu
+// time of its thread and the sequence number of the burst after each chunk.
+// Bursts that end by blocking are I/O-bound, waiting WORKLOAD_IO_WAIT_US
+// between chunks as if on a device, and the others are cpu-bound.
+//
+// oss makes the burst field of the process's block even before each dispatch.
+// Whichever of the process and oss first makes it odd owns the end of the
+// burst: the process by replying, or oss by stopping it once the quantum is
+// used up, so a process never replies to a burst oss has already ended.
+
+#include <limits.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "burst.h"
+#include "constants.h"
+#include "workload.h"
+
+#define CALIBRATION_LOOPS (1UL << 22)	// Loops timed by calibrateWorkload
+
+// Spins for loops iterations of dependent arithmetic
+static void spin(unsigned long loops){
+	static volatile unsigned long sink;
+	unsigned long x = sink, i;
+
+	for (i = 0; i < loops; i++)
+		x = x * 6364136223846793005UL + 1442695040888963407UL;
+
+	sink = x;
+}
+
+// Returns the cpu time of the calling thread in nanoseconds
+static unsigned long threadNs(){
+	struct timespec now;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+	return now.tv_sec * (unsigned long) BILLION + now.tv_nsec;
+}
+
+// Returns the number of spin loops that take about a microsecond of cpu time
+unsigned long calibrateWorkload(){
+	unsigned long start = threadNs(), loops;
+
+	spin(CALIBRATION_LOOPS);
+	loops = CALIBRATION_LOOPS * 1000 / (threadNs() - start + 1);
+
+	return loops > 0 ? loops : 1;
+}
+
+// Spends the cpu time of a reply made by simulateBurst, or spins until oss
+// ends the burst if the process uses its whole quantum, then replaces the time
+// in the reply with the time measured. Returns nonzero if the reply should be
+// sent, or 0 if oss ended the burst first.
+int executeBurst(ProcessControlBlock * pcb, char * reply,
+		 unsigned long loopsPerUs){
+	struct timespec ioWait = {0, WORKLOAD_IO_WAIT_US * 1000};
+	unsigned int burst = __atomic_load_n(&pcb->burst, __ATOMIC_ACQUIRE);
+	unsigned long start = threadNs(), goal = ULONG_MAX, used = 0;
+
+	// Returns at once if oss ended the burst before it began
+	if (burst & 1) return 0;
+
+	if (reply[0] != USES_ALL_QUANTUM_CH)
+		goal = strtoul(reply + 2, NULL, 10);
+
+	while (used < goal
+	       && __atomic_load_n(&pcb->burst, __ATOMIC_ACQUIRE) == burst){
+		spin(loopsPerUs * WORKLOAD_CHUNK_US);
+		if (reply[0] == WAITING_FOR_IO_CH)
+			nanosleep(&ioWait, NULL);
+		used = threadNs() - start;
+	}
+
+	// Claims the end of the burst unless oss claimed it first
+	if (!__atomic_compare_exchange_n(&pcb->burst, &burst, burst + 1, 0,
+					 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return 0;
+
+	setBurstTime(reply, used);
+
+	return 1;
+}
@@ -0,0 +1,16 @@
+// workload.h was created by Mark Renard on 10/19/2026.
+//
+// This file contains headers for functions that let a user process spend the
+// cpu time of its bursts for real when oss runs with -X, rather than only
+// reporting it.
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "pcb.h"
+
+unsigned long calibrateWorkload();
+int executeBurst(ProcessControlBlock * pcb, char * reply,
+		 unsigned long loopsPerUs);
+
+#endif